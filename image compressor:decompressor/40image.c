@@ -7,44 +7,205 @@
  *              processes command-line arguments
  * 
  ***********************************************************************/
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/resource.h>
 #include "assert.h"
 #include "compress40.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+#include "batch.h"
 
-static void (*compress_or_decompress)(FILE *input) = compress40;
+/* direction and pipeline; the default compresses with the streaming
+ * pipeline.  -s and -b select the staged one, -i integer-only kernels,
+ * -p reading and writing on their own threads */
+static compress40_mode mode = { false, false, false, NULL, 0, false };
+
+/* --max-memory: peak resident bytes the whole run should stay under */
+static size_t max_memory = 0;
+
+/* -o: the file the single output goes to instead of stdout, or NULL */
+static const char *output = NULL;
+
+/* batch mode: where default outputs go and the manifest, if any */
+static const char *batch_dir = NULL;
+static const char *manifest = NULL;
+
+static void usage(const char *progname)
+{
+        fprintf(stderr, 
+                "Usage: %s -d [-s | -b | -i] [-p] [-j threads] "
+                "[--max-memory size] [-o output] [filename]\n"
+                "       %s -c [-s | -b | -i] [-p] [-j threads] "
+                "[--max-memory size] [-o output] [filename]\n"
+                "       %s -c | -d [-s | -b | -i] [-p] [-j threads] "
+                "[--max-memory size] [-B outdir] [-m manifest] "
+                "filename...\n"
+                "size is in bytes, or with a K, M or G suffix; it cannot "
+                "be used with -s or -b\n",
+                progname, progname, progname);
+        exit(1);
+}
+
+/* parses a --max-memory size: a number of bytes, optionally followed by
+ * K, M or G; returns 0 when it is not one */
+static size_t parse_size(const char *arg)
+{
+        char *end;
+        unsigned long long n = strtoull(arg, &end, 10);
+        unsigned shift = 0;
+        if (end == arg) {
+                return 0;
+        }
+        if (*end == 'K' || *end == 'k') {
+                shift = 10;
+        } else if (*end == 'M' || *end == 'm') {
+                shift = 20;
+        } else if (*end == 'G' || *end == 'g') {
+                shift = 30;
+        }
+        if (shift > 0) {
+                end++;
+        }
+        if (*end != '\0' || n > (SIZE_MAX >> shift)) {
+                return 0;
+        }
+        return (size_t) n << shift;
+}
+
+/* the part of the --max-memory budget left for the images: what the
+ * process already holds before any image is read is taken off */
+static size_t image_budget(size_t budget)
+{
+        struct rusage usage;
+        size_t held = 0;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+                held = (size_t) usage.ru_maxrss * 1024;
+        }
+        return (budget > held + 1) ? budget - held : 1;
+}
+
+/* converts every file named on the command line or in the manifest, and
+ * prints the timing of each to stderr */
+static int run_batch(int argc, char *argv[], int i)
+{
+        batch b = batch_new(mode, batch_dir);
+        if (manifest != NULL) {
+                FILE *fp = (strcmp(manifest, "-") == 0) ? stdin :
+                                                          fopen(manifest, "r");
+                assert(fp != NULL);
+                batch_add_manifest(b, fp);
+                if (fp != stdin) {
+                        fclose(fp);
+                }
+        }
+        for (; i < argc; i++) {
+                batch_add(b, argv[i], NULL);
+        }
+        unsigned failed = batch_run(b, stderr);
+        batch_free(&b);
+        return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
 int main(int argc, char *argv[])
 {
         int i;
+        bool threads_set = false;       /* -j was given */
 
         for (i = 1; i < argc; i++) {
                 if (strcmp(argv[i], "-c") == 0) {
-                        compress_or_decompress = compress40;
+                        mode.decompress = false;
                 } else if (strcmp(argv[i], "-d") == 0) {
-                        compress_or_decompress = decompress40;
+                        mode.decompress = true;
+                } else if (strcmp(argv[i], "-s") == 0) {
+                        mode.staged = uarray2_methods_plain;
+                } else if (strcmp(argv[i], "-b") == 0) {
+                        mode.staged = uarray2_methods_blocked;
+                } else if (strcmp(argv[i], "-i") == 0) {
+                        mode.fixed = true;
+                } else if (strcmp(argv[i], "-p") == 0) {
+                        mode.pipelined = true;
+                } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                        /* threads for the streaming pipelines, 0 = all */
+                        char *end;
+                        unsigned long n = strtoul(argv[++i], &end, 10);
+                        if (*argv[i] == '\0' || *end != '\0' || n > 1024) {
+                                fprintf(stderr, "%s: bad thread count '%s'\n",
+                                        argv[0], argv[i]);
+                                exit(1);
+                        }
+                        compress40_set_threads((unsigned) n);
+                        threads_set = true;
+                } else if (strcmp(argv[i], "--max-memory") == 0 && 
+                           i + 1 < argc) {
+                        max_memory = parse_size(argv[++i]);
+                        if (max_memory == 0) {
+                                fprintf(stderr, "%s: bad memory size '%s'\n",
+                                        argv[0], argv[i]);
+                                exit(1);
+                        }
+                } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+                        /* opened once every option has been checked */
+                        output = argv[++i];
+                } else if (strcmp(argv[i], "-B") == 0 && i + 1 < argc) {
+                        batch_dir = argv[++i];
+                } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+                        manifest = argv[++i];
                 } else if (*argv[i] == '-') {
                         fprintf(stderr, "%s: unknown option '%s'\n",
                                 argv[0], argv[i]);
                         exit(1);
-                } else if (argc - i > 2) {
-                        fprintf(stderr, "Usage: %s -d [filename]\n"
-                                "       %s -c [filename]\n",
-                                argv[0], argv[0]);
-                        exit(1);
+                } else if (batch_dir == NULL && manifest == NULL && 
+                           argc - i > 2) {
+                        usage(argv[0]);
                 } else {
                         break;
                 }
         }
+        /* the integer kernels exist only in the streaming pipeline */
+        if (mode.fixed && mode.staged != NULL) {
+                usage(argv[0]);
+        }
+        if (max_memory > 0) {
+                /* the staged pipeline holds whole images */
+                if (mode.staged != NULL) {
+                        usage(argv[0]);
+                }
+                mode.max_memory = image_budget(max_memory);
+        }
+        if (batch_dir != NULL || manifest != NULL) {
+                if (output != NULL) {
+                        usage(argv[0]);
+                }
+                /* one invocation should keep every cpu busy */
+                if (!threads_set) {
+                        compress40_set_threads(0);
+                }
+                return run_batch(argc, argv, i);
+        }
+
         assert(argc - i <= 1);    /* at most one file on command line */
+        FILE *fp = stdin;
         if (i < argc) {
-                FILE *fp = fopen(argv[i], "r");
+                fp = fopen(argv[i], "r");
                 assert(fp != NULL);
-                compress_or_decompress(fp);
+        }
+        if (output != NULL) {
+                /* output goes to a file, which is preallocated */
+                if (freopen(output, "w", stdout) == NULL) {
+                        fprintf(stderr, "%s: cannot open '%s': %s\n",
+                                argv[0], output, strerror(errno));
+                        exit(1);
+                }
+                mode.reserve = true;
+        }
+        compress40_run(fp, stdout, mode);
+        if (fp != stdin) {
                 fclose(fp);
-        } else {
-                compress_or_decompress(stdin);
         }
 
         return EXIT_SUCCESS; 
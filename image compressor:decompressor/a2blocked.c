@@ -0,0 +1,237 @@
+#include <a2blocked.h>
+#include "uarray2b.h"
+#include "threadpool.h"
+
+/* 
+ * The codec works on 2 by 2 blocks of pixels, so unless told otherwise
+ * each block of a blocked array holds exactly one of them
+ */
+#define DEFAULT_BLOCKSIZE 2
+
+/************************************************/
+/* Define a private version of each function in */
+/* A2Methods_T that we implement.               */
+/************************************************/
+
+static A2Methods_UArray2 new(int width, int height, int size)
+{
+        return UArray2b_new(width, height, size, DEFAULT_BLOCKSIZE);
+}
+
+static A2Methods_UArray2 new_with_blocksize(int width, int height, int size,
+                                            int blocksize)
+{
+        return UArray2b_new(width, height, size, blocksize);
+}
+
+static void a2free(A2Methods_UArray2 * array2p)
+{
+        UArray2b_free((UArray2b_T *) array2p);
+}
+
+static size_t bytes(int width, int height, int size)
+{
+        return UArray2b_bytes(width, height, size, DEFAULT_BLOCKSIZE);
+}
+
+static A2Methods_UArray2 new_in(void *mem, int width, int height, int size)
+{
+        return UArray2b_new_in(mem, width, height, size, DEFAULT_BLOCKSIZE);
+}
+
+static int width(A2Methods_UArray2 array2)
+{
+        return UArray2b_width(array2);
+}
+
+static int height(A2Methods_UArray2 array2)
+{
+        return UArray2b_height(array2);
+}
+
+static int size(A2Methods_UArray2 array2)
+{
+        return UArray2b_size(array2);
+}
+
+static int blocksize(A2Methods_UArray2 array2)
+{
+        return UArray2b_blocksize(array2);
+}
+
+static void trim(A2Methods_UArray2 array2, int width, int height)
+{
+        UArray2b_trim(array2, width, height);
+}
+
+static A2Methods_Object *at(A2Methods_UArray2 array, int i, int j)
+{
+        return UArray2b_at(array, i, j);
+}
+
+/* 
+ * row- and column-major orders are supported for clients such as the
+ * Pnm reader, but they lose the locality of the blocks
+ */
+static void map_row_major(A2Methods_UArray2 array2,
+                          A2Methods_applyfun apply,
+                          void *cl)
+{
+        int w = UArray2b_width(array2);
+        int h = UArray2b_height(array2);
+        for (int j = 0; j < h; j++)
+                for (int i = 0; i < w; i++)
+                        apply(i, j, array2, UArray2b_at(array2, i, j), cl);
+}
+
+static void map_col_major(A2Methods_UArray2 array2,
+                          A2Methods_applyfun apply,
+                          void *cl)
+{
+        int w = UArray2b_width(array2);
+        int h = UArray2b_height(array2);
+        for (int i = 0; i < w; i++)
+                for (int j = 0; j < h; j++)
+                        apply(i, j, array2, UArray2b_at(array2, i, j), cl);
+}
+
+static void map_block_major(A2Methods_UArray2 array2,
+                            A2Methods_applyfun apply,
+                            void *cl)
+{
+        UArray2b_map(array2, (UArray2b_applyfun *)apply, cl);
+}
+
+struct parallel_closure {
+        A2Methods_UArray2   array2;
+        A2Methods_applyfun *apply;
+        void               *cl;
+};
+
+static void map_block_row_range(unsigned first, unsigned last, void *vcl)
+{
+        struct parallel_closure *cl = vcl;
+        UArray2b_map_block_rows(cl->array2, first, last,
+                                (UArray2b_applyfun *)cl->apply, cl->cl);
+}
+
+/* each thread of the shared pool takes whole rows of blocks, so every
+ * block is still visited by one thread in one pass */
+static void map_parallel(A2Methods_UArray2 array2,
+                         A2Methods_applyfun apply,
+                         void *cl)
+{
+        struct parallel_closure mycl = { array2, apply, cl };
+        threadpool_for(threadpool_shared(), UArray2b_block_rows(array2),
+                       map_block_row_range, &mycl);
+}
+
+struct small_closure {
+        A2Methods_smallapplyfun *apply; 
+        void                    *cl;
+};
+
+static void apply_small(int i, int j, A2Methods_UArray2 array2,
+                        A2Methods_Object *elem, void *vcl)
+{
+        struct small_closure *cl = vcl;
+        (void)i;
+        (void)j;
+        (void)array2;
+        cl->apply(elem, cl->cl);
+}
+
+static void small_map_row_major(A2Methods_UArray2        a2,
+                                A2Methods_smallapplyfun  apply,
+                                void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_row_major(a2, apply_small, &mycl);
+}
+
+static void small_map_col_major(A2Methods_UArray2        a2,
+                                A2Methods_smallapplyfun  apply,
+                                void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_col_major(a2, apply_small, &mycl);
+}
+
+static void small_map_block_major(A2Methods_UArray2        a2,
+                                  A2Methods_smallapplyfun  apply,
+                                  void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_block_major(a2, apply_small, &mycl);
+}
+
+static void small_map_parallel(A2Methods_UArray2        a2,
+                               A2Methods_smallapplyfun  apply,
+                               void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_parallel(a2, apply_small, &mycl);
+}
+
+/* a block of the array at a time, like map_block_major */
+static void map_2x2_blocks(A2Methods_UArray2 array2,
+                           A2Methods_blockapplyfun apply,
+                           void *cl)
+{
+        UArray2b_map_2x2(array2, 0, UArray2b_block_rows(array2),
+                         (UArray2b_apply2x2fun *)apply, cl);
+}
+
+struct block_closure {
+        A2Methods_UArray2        array2;
+        A2Methods_blockapplyfun *apply;
+        void                    *cl;
+};
+
+static void map_2x2_range(unsigned first, unsigned last, void *vcl)
+{
+        struct block_closure *cl = vcl;
+        UArray2b_map_2x2(cl->array2, first, last,
+                         (UArray2b_apply2x2fun *)cl->apply, cl->cl);
+}
+
+/* each thread of the shared pool takes whole rows of blocks */
+static void map_2x2_blocks_parallel(A2Methods_UArray2 array2,
+                                    A2Methods_blockapplyfun apply,
+                                    void *cl)
+{
+        struct block_closure mycl = { array2, apply, cl };
+        threadpool_for(threadpool_shared(), UArray2b_block_rows(array2),
+                       map_2x2_range, &mycl);
+}
+
+
+static struct A2Methods_T uarray2_methods_blocked_struct = {
+        new,
+        new_with_blocksize,
+        a2free,
+        width,
+        height,
+        size,
+        blocksize,
+        at,
+        map_row_major,
+        map_col_major,
+        map_block_major,
+        map_block_major,              // map_default
+        small_map_row_major,
+        small_map_col_major,
+        small_map_block_major,
+        small_map_block_major,        // small_map_default
+        trim,
+        map_parallel,
+        small_map_parallel,
+        bytes,
+        new_in,
+        map_2x2_blocks,
+        map_2x2_blocks_parallel,
+};
+
+// finally the payoff: here is the exported pointer to the struct
+
+A2Methods_T uarray2_methods_blocked = &uarray2_methods_blocked_struct;
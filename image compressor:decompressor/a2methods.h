@@ -1,5 +1,6 @@
 #ifndef A2METHODS_INCLUDED
 #define A2METHODS_INCLUDED
+#include <stddef.h>
 
 #define A2 A2Methods_UArray2
 
@@ -18,6 +19,13 @@ typedef void A2Methods_mapfun(A2 array2, A2Methods_applyfun apply, void *cl);
 typedef void A2Methods_smallapplyfun(A2Methods_Object *ptr, void *cl);
 typedef void A2Methods_smallmapfun(A2 a2, A2Methods_smallapplyfun f, void *cl);
 
+/* i and j locate a 2x2 block: its cells are (2i, 2j), (2i + 1, 2j),
+ * (2i, 2j + 1) and (2i + 1, 2j + 1), passed in that order in 'cells' */
+typedef void A2Methods_blockapplyfun(int i, int j, A2 array2,
+                                     A2Methods_Object *cells[4], void *cl);
+typedef void A2Methods_blockmapfun(A2 array2, A2Methods_blockapplyfun apply,
+                                   void *cl);
+
 /* operations on 2D arrays */
 
 /*
@@ -98,6 +106,44 @@ typedef struct A2Methods_T {
         void (*small_map_default)    (A2 a2, A2Methods_smallapplyfun apply,
                                       void *cl);
 
+        /* extensions; new members go after the course members so code
+         * built against the original record still finds them in place */
+
+        /* shrinks array2 in place to its top-left width x height cells,
+         * without moving or copying them (CRE to grow the array).
+         * May be NULL
+         */
+        void (*trim)(A2 array2, int width, int height);
+        /* visit every cell exactly once, like map_default, but split the
+         * rows (or rows of blocks) among the threads of the shared thread
+         * pool, so calls to 'apply' may run at the same time and in any
+         * order.  No two calls get the same cell, and the calls are done
+         * when the map returns.  'apply' may write only its own cell and
+         * memory no other call touches; 'cl' must be read-only.
+         * Either may be NULL
+         */
+        void (*map_parallel)(A2 array2, A2Methods_applyfun apply, void *cl);
+        void (*small_map_parallel)(A2 a2, A2Methods_smallapplyfun apply,
+                                   void *cl);
+        /* the bytes of memory new_in needs for an array like the one new
+         * makes, and an array of uninitialized cells placed in such
+         * memory, which stays the caller's: 'free' only clears the
+         * pointer.  Either may be NULL
+         */
+        size_t (*bytes)(int width, int height, int size);
+        A2(*new_in)(void *mem, int width, int height, int size);
+        /* visit every 2x2 block of cells once, handing 'apply' all four
+         * of its cells at the same time; a trailing odd row or column
+         * is not visited.  The parallel version splits the blocks among
+         * the threads of the shared pool, with the rules of
+         * map_parallel.  Either may be NULL
+         */
+        void (*map_2x2_blocks)(A2 array2, A2Methods_blockapplyfun apply,
+                               void *cl);
+        void (*map_2x2_blocks_parallel)(A2 array2,
+                                        A2Methods_blockapplyfun apply,
+                                        void *cl);
+
 } *A2Methods_T;
 
 #undef A2
@@ -2,6 +2,7 @@
 
 #include <a2plain.h>
 #include "uarray2.h"
+#include "threadpool.h"
 
 /************************************************/
 /* Define a private version of each function in */
@@ -29,6 +30,16 @@ static void a2free(A2Methods_UArray2 * array2p)
         UArray2_free((UArray2_T *) array2p);
 }
 
+static size_t bytes(int width, int height, int size)
+{
+        return UArray2_bytes(width, height, size);
+}
+
+static A2Methods_UArray2 new_in(void *mem, int width, int height, int size)
+{
+        return UArray2_new_in(mem, width, height, size);
+}
+
 static int width(A2Methods_UArray2 array2)
 {
         return UArray2_width(array2);
@@ -50,6 +61,11 @@ static int blocksize(A2Methods_UArray2 array2)
         return 1;
 }
 
+static void trim(A2Methods_UArray2 array2, int width, int height)
+{
+        UArray2_trim(array2, width, height);
+}
+
 static A2Methods_Object *at(A2Methods_UArray2 array, int i, int j)
 {
         return UArray2_at(array, i, j);
@@ -69,6 +85,29 @@ static void map_col_major(A2Methods_UArray2 uarray2,
         UArray2_map_col_major(uarray2, (UArray2_applyfun*)apply, cl);
 }
 
+struct parallel_closure {
+        A2Methods_UArray2   array2;
+        A2Methods_applyfun *apply;
+        void               *cl;
+};
+
+static void map_row_range(unsigned first, unsigned last, void *vcl)
+{
+        struct parallel_closure *cl = vcl;
+        UArray2_map_rows(cl->array2, first, last,
+                         (UArray2_applyfun *)cl->apply, cl->cl);
+}
+
+/* each thread of the shared pool takes whole rows */
+static void map_parallel(A2Methods_UArray2 uarray2,
+                         A2Methods_applyfun apply,
+                         void *cl)
+{
+        struct parallel_closure mycl = { uarray2, apply, cl };
+        threadpool_for(threadpool_shared(), UArray2_height(uarray2),
+                       map_row_range, &mycl);
+}
+
 struct small_closure {
         A2Methods_smallapplyfun *apply; 
         void                    *cl;
@@ -100,6 +139,46 @@ static void small_map_col_major(A2Methods_UArray2        a2,
         UArray2_map_col_major(a2, apply_small, &mycl);
 }
 
+static void small_map_parallel(A2Methods_UArray2        a2,
+                               A2Methods_smallapplyfun  apply,
+                               void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_parallel(a2, (A2Methods_applyfun *)apply_small, &mycl);
+}
+
+/* both rows of a block row are walked together with row pointers */
+static void map_2x2_blocks(A2Methods_UArray2 uarray2,
+                           A2Methods_blockapplyfun apply,
+                           void *cl)
+{
+        UArray2_map_2x2(uarray2, 0, UArray2_height(uarray2) / 2,
+                        (UArray2_apply2x2fun *)apply, cl);
+}
+
+struct block_closure {
+        A2Methods_UArray2        array2;
+        A2Methods_blockapplyfun *apply;
+        void                    *cl;
+};
+
+static void map_2x2_range(unsigned first, unsigned last, void *vcl)
+{
+        struct block_closure *cl = vcl;
+        UArray2_map_2x2(cl->array2, first, last,
+                        (UArray2_apply2x2fun *)cl->apply, cl->cl);
+}
+
+/* each thread of the shared pool takes whole rows of 2x2 blocks */
+static void map_2x2_blocks_parallel(A2Methods_UArray2 uarray2,
+                                    A2Methods_blockapplyfun apply,
+                                    void *cl)
+{
+        struct block_closure mycl = { uarray2, apply, cl };
+        threadpool_for(threadpool_shared(), UArray2_height(uarray2) / 2,
+                       map_2x2_range, &mycl);
+}
+
 
 static struct A2Methods_T uarray2_methods_plain_struct = {
         new,
@@ -118,6 +197,13 @@ static struct A2Methods_T uarray2_methods_plain_struct = {
         small_map_col_major,
         NULL,
         small_map_row_major,          // small_map_default
+        trim,
+        map_parallel,
+        small_map_parallel,
+        bytes,
+        new_in,
+        map_2x2_blocks,
+        map_2x2_blocks_parallel,
 };
 
 // finally the payoff: here is the exported pointer to the struct
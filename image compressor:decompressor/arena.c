@@ -0,0 +1,228 @@
+/***********************************************************************
+ * 
+ *                      arena.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements the arena. Allocations come from
+ *              the main block; what does not fit goes to an overflow
+ *              block of its own, and at the next reset the main block
+ *              grows to the high-water mark of the round so the
+ *              overflow is not needed again. Memory recycled during a
+ *              round is handed out again before either, and does not
+ *              count toward the high-water mark.
+ * 
+ ***********************************************************************/
+#include <stdlib.h>
+#include <stdint.h>
+#include "assert.h"
+#include "arena.h"
+
+/*alignment of every allocation, one cache line*/
+#define ALIGNMENT 64
+/*size of the first main block*/
+#define FIRST_BLOCK (64 * 1024)
+
+/*pieces of recycled memory remembered per round; more are dropped*/
+#define MAX_SPARE 8
+
+/*a block allocated when the main block was full*/
+struct overflow {
+        struct overflow *next;
+        unsigned char *mem;
+};
+
+/*recycled memory not handed out again yet*/
+struct spare {
+        unsigned char *mem;
+        size_t nbytes;
+};
+
+struct arena {
+        unsigned char *base;            /*main block*/
+        size_t cap;                     /*bytes in the main block*/
+        size_t used;                    /*bytes of it handed out*/
+        size_t round;                   /*bytes handed out since reset*/
+        struct overflow *overflow;
+        struct spare spare[MAX_SPARE];
+        unsigned nspare;
+};
+
+static unsigned char *new_block(size_t nbytes)
+{
+        void *mem = NULL;
+        int failed = posix_memalign(&mem, ALIGNMENT, nbytes);
+        assert(failed == 0 && mem != NULL);
+        return mem;
+}
+
+static size_t round_up(size_t n)
+{
+        return (n + ALIGNMENT - 1) & ~(size_t) (ALIGNMENT - 1);
+}
+
+/**************************arena_new********************************
+ * 
+ * Parameters:
+ *      None
+ * 
+ * Return: 
+ *      an empty arena
+ * 
+ * Expects: None
+ * 
+ * Notes: CRE is raised when malloc fails
+ * 
+ * *******************************************************************/
+arena arena_new(void)
+{
+        arena a = malloc(sizeof(*a));
+        assert(a != NULL);
+        a->cap = FIRST_BLOCK;
+        a->base = new_block(a->cap);
+        a->used = 0;
+        a->round = 0;
+        a->overflow = NULL;
+        a->nspare = 0;
+        return a;
+}
+
+/**************************arena_alloc********************************
+ * 
+ * Parameters:
+ *      arena a: arena to allocate from
+ *      size_t nbytes: bytes wanted
+ * 
+ * Return: 
+ *      nbytes of uninitialized memory aligned to a cache line
+ * 
+ * Expects: valid arena
+ * 
+ * Notes: CRE is raised when malloc fails. The first recycled piece big
+ *      enough is used before the main block
+ * 
+ * *******************************************************************/
+void *arena_alloc(arena a, size_t nbytes)
+{
+        assert(a != NULL);
+        nbytes = round_up(nbytes > 0 ? nbytes : 1);
+        for (unsigned k = 0; k < a->nspare; k++) {
+                if (a->spare[k].nbytes >= nbytes) {
+                        void *mem = a->spare[k].mem;
+                        a->spare[k].mem += nbytes;
+                        a->spare[k].nbytes -= nbytes;
+                        return mem;
+                }
+        }
+        a->round += nbytes;
+        if (a->cap - a->used >= nbytes) {
+                void *mem = a->base + a->used;
+                a->used += nbytes;
+                return mem;
+        }
+
+        struct overflow *block = malloc(sizeof(*block));
+        assert(block != NULL);
+        block->mem = new_block(nbytes);
+        block->next = a->overflow;
+        a->overflow = block;
+        return block->mem;
+}
+
+/**************************arena_array********************************
+ * 
+ * Parameters:
+ *      arena a: arena to allocate from
+ *      A2Methods_T methods: methods the array is made and used by
+ *      int width, height, size: as for methods->new
+ * 
+ * Return: 
+ *      a new array placed in the arena's memory
+ * 
+ * Expects: valid arena, and methods that provide bytes and new_in
+ * 
+ * *******************************************************************/
+A2Methods_UArray2 arena_array(arena a, A2Methods_T methods,
+        int width, int height, int size)
+{
+        assert(methods != NULL);
+        assert(methods->bytes != NULL && methods->new_in != NULL);
+        size_t nbytes = methods->bytes(width, height, size);
+        return methods->new_in(arena_alloc(a, nbytes), width, height, size);
+}
+
+/**************************arena_recycle********************************
+ * 
+ * Parameters:
+ *      arena a: arena the array came from
+ *      A2Methods_T methods: methods the array was made by
+ *      A2Methods_UArray2 array: array from arena_array on a
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arena and methods, and an array that is not used again
+ * 
+ * *******************************************************************/
+void arena_recycle(arena a, A2Methods_T methods, A2Methods_UArray2 array)
+{
+        assert(a != NULL && methods != NULL && array != NULL);
+        if (a->nspare == MAX_SPARE) {
+                return;
+        }
+        size_t nbytes = methods->bytes(methods->width(array), 
+                methods->height(array), methods->size(array));
+        a->spare[a->nspare].mem = (unsigned char *) array;
+        a->spare[a->nspare].nbytes = nbytes & ~(size_t) (ALIGNMENT - 1);
+        a->nspare++;
+}
+
+/**************************arena_reset********************************
+ * 
+ * Parameters:
+ *      arena a: arena to reset
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arena
+ * 
+ * *******************************************************************/
+void arena_reset(arena a)
+{
+        assert(a != NULL);
+        if (a->overflow != NULL) {
+                while (a->overflow != NULL) {
+                        struct overflow *next = a->overflow->next;
+                        free(a->overflow->mem);
+                        free(a->overflow);
+                        a->overflow = next;
+                }
+                free(a->base);
+                a->cap = a->round;
+                a->base = new_block(a->cap);
+        }
+        a->used = 0;
+        a->round = 0;
+        a->nspare = 0;
+}
+
+/**************************arena_free********************************
+ * 
+ * Parameters:
+ *      arena *a: pointer to the arena to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to an arena
+ * 
+ * *******************************************************************/
+void arena_free(arena *a)
+{
+        assert(a != NULL && *a != NULL);
+        arena_reset(*a);
+        free((*a)->base);
+        free(*a);
+        *a = NULL;
+}
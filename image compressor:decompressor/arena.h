@@ -0,0 +1,128 @@
+/***********************************************************************
+ * 
+ *                      arena.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the interface to the arena that the
+ *              buffers and arrays of one image are allocated from
+ * 
+ ***********************************************************************/
+#ifndef ARENA_INCLUDED
+#define ARENA_INCLUDED
+
+#include <stddef.h>
+#include "a2methods.h"
+
+/*memory handed out by bumping a pointer and given back all at once*/
+typedef struct arena *arena;
+
+/**************************arena_new********************************
+ * 
+ * Parameters:
+ *      None
+ * 
+ * Return: 
+ *      an empty arena
+ * 
+ * Expects: None
+ * 
+ * Notes: CRE is raised when malloc fails
+ * 
+ * *******************************************************************/
+extern arena arena_new(void);
+
+/**************************arena_alloc********************************
+ * 
+ * Parameters:
+ *      arena a: arena to allocate from
+ *      size_t nbytes: bytes wanted
+ * 
+ * Return: 
+ *      nbytes of uninitialized memory aligned to a cache line, valid until
+ *      the arena is reset or freed
+ * 
+ * Expects: valid arena
+ * 
+ * Notes: CRE is raised when malloc fails. The memory must not be freed
+ * 
+ * *******************************************************************/
+extern void *arena_alloc(arena a, size_t nbytes);
+
+/**************************arena_array********************************
+ * 
+ * Parameters:
+ *      arena a: arena to allocate from
+ *      A2Methods_T methods: methods the array is made and used by
+ *      int width, height, size: as for methods->new
+ * 
+ * Return: 
+ *      a new array of uninitialized cells placed in the arena's memory
+ * 
+ * Expects: valid arena, and methods that provide bytes and new_in
+ * 
+ * Notes: the array lives until the arena is reset or freed; passing it
+ *      to methods->free is allowed and does nothing but clear the
+ *      pointer
+ * 
+ * *******************************************************************/
+extern A2Methods_UArray2 arena_array(arena a, A2Methods_T methods,
+        int width, int height, int size);
+
+/**************************arena_recycle********************************
+ * 
+ * Parameters:
+ *      arena a: arena the array came from
+ *      A2Methods_T methods: methods the array was made by
+ *      A2Methods_UArray2 array: array from arena_array on a
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arena and methods, and an array that is not used again
+ *      in this round
+ * 
+ * Notes: hands the memory of a stage that is done with back to the
+ *      arena, so the arrays of later stages that fit in it are placed
+ *      there instead of in new memory. A round remembers a few such
+ *      pieces; the memory of any more is simply left unused
+ * 
+ * *******************************************************************/
+extern void arena_recycle(arena a, A2Methods_T methods,
+        A2Methods_UArray2 array);
+
+/**************************arena_reset********************************
+ * 
+ * Parameters:
+ *      arena a: arena to reset
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arena
+ * 
+ * Notes: takes back everything allocated from a, but keeps the memory.
+ *      When the last round needed more than one block, the blocks are
+ *      replaced by one block as big as all of them, so a round of the
+ *      same size after a reset calls malloc no more and touches pages
+ *      that are already mapped
+ * 
+ * *******************************************************************/
+extern void arena_reset(arena a);
+
+/**************************arena_free********************************
+ * 
+ * Parameters:
+ *      arena *a: pointer to the arena to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to an arena
+ * 
+ * Notes: releases all the memory of the arena and sets *a to NULL
+ * 
+ * *******************************************************************/
+extern void arena_free(arena *a);
+
+#endif
@@ -0,0 +1,455 @@
+/***********************************************************************
+ * 
+ *                      batch.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements batch mode. Every image is a task
+ *              of the shared thread pool; a task opens its own input and
+ *              output, runs compress40_run between them and times it.
+ *              Tasks run largest first so the last ones to start are
+ *              small and the threads finish together.
+ * 
+ *              CII keeps one stack of TRY frames for the whole process,
+ *              so an exception may only be caught on the calling thread.
+ *              Every input is checked there first with compress40_check;
+ *              only images that can no longer raise go to the pool, and
+ *              the rest are converted one at a time under a TRY.
+ * 
+ ***********************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "assert.h"
+#include "except.h"
+#include "batch.h"
+#include "wordio.h"
+#include "threadpool.h"
+
+/*a job and the size it is scheduled by*/
+struct job_size {
+        uint64_t bytes;
+        unsigned job;
+};
+
+/*a job and the path it writes*/
+struct job_output {
+        const char *output;
+        unsigned job;
+};
+
+/*the jobs of a batch in the order they are run*/
+struct batch_order {
+        batch b;
+        struct job_size *order;
+        compress40_mode mode;   /*mode of every job, with its share of the
+                                  memory budget*/
+};
+
+static char *copy_string(const char *s, size_t len)
+{
+        char *copy = malloc(len + 1);
+        assert(copy != NULL);
+        memcpy(copy, s, len);
+        copy[len] = '\0';
+        return copy;
+}
+
+/*true when name ends in suffix*/
+static bool has_suffix(const char *name, size_t len, const char *suffix)
+{
+        size_t slen = strlen(suffix);
+        return len > slen && strcmp(name + len - slen, suffix) == 0;
+}
+
+/*the default output name of input, as described in batch.h*/
+static char *output_name(batch b, const char *input)
+{
+        const char *name = input;
+        if (b->outdir != NULL) {
+                const char *slash = strrchr(input, '/');
+                name = (slash != NULL) ? slash + 1 : input;
+        }
+        size_t len = strlen(name);
+        const char *suffix = b->mode.decompress ? ".ppm" : ".c40";
+        if (b->mode.decompress && has_suffix(name, len, ".c40")) {
+                len -= 4;
+        } else if (!b->mode.decompress && (has_suffix(name, len, ".ppm") ||
+                                           has_suffix(name, len, ".pnm"))) {
+                len -= 4;
+        }
+
+        size_t dirlen = (b->outdir != NULL) ? strlen(b->outdir) : 0;
+        char *output = malloc(dirlen + 1 + len + strlen(suffix) + 1);
+        assert(output != NULL);
+        char *p = output;
+        if (b->outdir != NULL) {
+                memcpy(p, b->outdir, dirlen);
+                p += dirlen;
+                *p++ = '/';
+        }
+        memcpy(p, name, len);
+        strcpy(p + len, suffix);
+        return output;
+}
+
+static double now(void)
+{
+        struct timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return (double) t.tv_sec + (double) t.tv_nsec * 1e-9;
+}
+
+/*true when the input of job is an image compress40_run cannot fail on
+ any more; an image that cannot be converted gets its error instead*/
+static bool check_job(batch_job *job, compress40_mode mode)
+{
+        FILE *in = fopen(job->input, "r");
+        if (in == NULL) {
+                job->error = "cannot open input";
+                return false;
+        }
+
+        volatile bool checked = false;
+        TRY
+                checked = compress40_check(in, mode);
+        EXCEPT(file_err)
+                job->error = file_err.reason;
+        ELSE
+                job->error = Except_frame.exception->reason;
+        END_TRY;
+        fclose(in);
+        return checked;
+}
+
+/*opens the input and output of job, or gives it its error*/
+static bool open_job(batch_job *job, FILE **in, FILE **out)
+{
+        *in = fopen(job->input, "r");
+        if (*in == NULL) {
+                job->error = "cannot open input";
+                return false;
+        }
+        *out = fopen(job->output, "w");
+        if (*out == NULL) {
+                fclose(*in);
+                job->error = "cannot open output";
+                return false;
+        }
+        return true;
+}
+
+/*closes the files of job and times it; a job that failed leaves no
+ output behind*/
+static void close_job(batch_job *job, FILE *in, FILE *out, double start)
+{
+        fclose(in);
+        if (fclose(out) != 0 && job->error == NULL) {
+                job->error = "cannot write output";
+        }
+        if (job->error != NULL) {
+                remove(job->output);
+        }
+        job->seconds = now() - start;
+}
+
+/*runs the task'th job in the batch order, one check_job passed*/
+static void run_job(unsigned task, void *cl)
+{
+        struct batch_order *run = cl;
+        batch_job *job = &run->b->jobs[run->order[task].job];
+        double start = now();
+        FILE *in, *out;
+        if (!open_job(job, &in, &out)) {
+                return;
+        }
+
+        compress40_run(in, out, run->mode);
+        close_job(job, in, out, start);
+}
+
+/*runs job on the calling thread, where an invalid image only fails its
+ own job; the pipelined mode would read it on another thread*/
+static void run_caught(batch_job *job, compress40_mode mode)
+{
+        double start = now();
+        FILE *in, *out;
+        if (!open_job(job, &in, &out)) {
+                return;
+        }
+
+        mode.pipelined = false;
+        TRY
+                compress40_run(in, out, mode);
+        EXCEPT(file_err)
+                job->error = file_err.reason;
+        ELSE
+                job->error = Except_frame.exception->reason;
+        END_TRY;
+        close_job(job, in, out, start);
+}
+
+/*qsort order of the jobs, largest input first*/
+static int larger_first(const void *x, const void *y)
+{
+        uint64_t a = ((const struct job_size *) x)->bytes;
+        uint64_t b = ((const struct job_size *) y)->bytes;
+        return (a < b) - (a > b);
+}
+
+/*qsort order of the jobs by output path, then in the order added*/
+static int by_output(const void *x, const void *y)
+{
+        const struct job_output *a = x;
+        const struct job_output *b = y;
+        int order = strcmp(a->output, b->output);
+        if (order != 0) {
+                return order;
+        }
+        return (a->job > b->job) - (a->job < b->job);
+}
+
+/*gives every job that writes the same path as a job added before it an
+ error, so two inputs of the same name in different directories do not
+ overwrite each other's output under -B*/
+static void find_duplicates(batch b)
+{
+        struct job_output *names = malloc((b->njobs + 1) * sizeof(*names));
+        assert(names != NULL);
+        for (unsigned k = 0; k < b->njobs; k++) {
+                names[k].output = b->jobs[k].output;
+                names[k].job = k;
+        }
+        qsort(names, b->njobs, sizeof(*names), by_output);
+
+        for (unsigned k = 1; k < b->njobs; k++) {
+                if (strcmp(names[k - 1].output, names[k].output) == 0) {
+                        b->jobs[names[k].job].error = 
+                                "output name used by another job";
+                }
+        }
+        free(names);
+}
+
+/**************************batch_new********************************
+ * 
+ * Parameters:
+ *      compress40_mode mode: direction and pipeline of every job
+ *      const char *outdir: directory of default outputs, or NULL
+ * 
+ * Return: 
+ *      a batch with no jobs
+ * 
+ * Expects: None
+ * 
+ * Notes: CRE is raised when malloc fails
+ * 
+ * *******************************************************************/
+batch batch_new(compress40_mode mode, const char *outdir)
+{
+        batch b = malloc(sizeof(*b));
+        assert(b != NULL);
+        b->mode = mode;
+        b->mode.reserve = true;         /*every output is opened by a job*/
+        b->outdir = outdir;
+        b->njobs = 0;
+        b->capacity = 16;
+        b->jobs = malloc(b->capacity * sizeof(*b->jobs));
+        assert(b->jobs != NULL);
+        return b;
+}
+
+/**************************batch_add********************************
+ * 
+ * Parameters:
+ *      batch b: batch the job is added to
+ *      const char *input: path of the image to convert
+ *      const char *output: path of the result, or NULL for the default
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid batch and input
+ * 
+ * *******************************************************************/
+void batch_add(batch b, const char *input, const char *output)
+{
+        assert(b != NULL && input != NULL);
+        if (b->njobs == b->capacity) {
+                b->capacity *= 2;
+                b->jobs = realloc(b->jobs, b->capacity * sizeof(*b->jobs));
+                assert(b->jobs != NULL);
+        }
+
+        batch_job *job = &b->jobs[b->njobs++];
+        job->input = copy_string(input, strlen(input));
+        job->output = (output != NULL) ? copy_string(output, strlen(output))
+                                       : output_name(b, input);
+        job->bytes = 0;
+        job->seconds = 0;
+        job->error = NULL;
+}
+
+/**************************batch_add_manifest********************************
+ * 
+ * Parameters:
+ *      batch b: batch the jobs are added to
+ *      FILE *manifest: open manifest file
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid batch and file pointer
+ * 
+ * *******************************************************************/
+void batch_add_manifest(batch b, FILE *manifest)
+{
+        assert(b != NULL && manifest != NULL);
+        const char *space = " \t\r\n";
+        char *line = NULL;
+        size_t cap = 0;
+
+        while (getline(&line, &cap, manifest) != -1) {
+                char *p = line + strspn(line, space);
+                if (*p == '\0' || *p == '#') {
+                        continue;
+                }
+                size_t inlen = strcspn(p, space);
+                char *q = p + inlen;
+                q += strspn(q, space);
+                size_t outlen = strcspn(q, space);
+
+                char *input = copy_string(p, inlen);
+                char *output = (outlen > 0) ? copy_string(q, outlen) : NULL;
+                batch_add(b, input, output);
+                free(input);
+                free(output);
+        }
+        free(line);
+}
+
+/**************************batch_run********************************
+ * 
+ * Parameters:
+ *      batch b: batch to run
+ *      FILE *report: stream of the timing report, or NULL
+ * 
+ * Return: 
+ *      the number of jobs that could not be run
+ * 
+ * Expects: valid batch
+ * 
+ * Notes: a job that runs while the pool is busy with the batch converts
+ *      its image on its own thread, so an image is only split across
+ *      threads when it is the only job. A memory budget in the mode is
+ *      split evenly between the images converted at once. The jobs
+ *      check_job cannot vouch for run afterwards, one at a time
+ * 
+ * *******************************************************************/
+unsigned batch_run(batch b, FILE *report)
+{
+        assert(b != NULL);
+        struct job_size *order = malloc((b->njobs + 1) * sizeof(*order));
+        assert(order != NULL);
+        double start = now();
+
+        find_duplicates(b);
+        for (unsigned k = 0; k < b->njobs; k++) {
+                struct stat st;
+                if (stat(b->jobs[k].input, &st) == 0) {
+                        b->jobs[k].bytes = (uint64_t) st.st_size;
+                } else if (b->jobs[k].error == NULL) {
+                        b->jobs[k].error = "cannot open input";
+                }
+                order[k].bytes = b->jobs[k].bytes;
+                order[k].job = k;
+        }
+        qsort(order, b->njobs, sizeof(*order), larger_first);
+
+        /*checked jobs first, still largest first, then the ones to run
+         under a TRY*/
+        unsigned nchecked = 0;
+        unsigned ncaught = 0;
+        unsigned *caught = malloc((b->njobs + 1) * sizeof(*caught));
+        assert(caught != NULL);
+        for (unsigned t = 0; t < b->njobs; t++) {
+                batch_job *job = &b->jobs[order[t].job];
+                if (job->error != NULL) {
+                        continue;
+                } else if (check_job(job, b->mode)) {
+                        order[nchecked++] = order[t];
+                } else if (job->error == NULL) {
+                        caught[ncaught++] = order[t].job;
+                }
+        }
+
+        /*the images in flight share the memory budget*/
+        struct batch_order run = { b, order, b->mode };
+        unsigned inflight = threadpool_size(threadpool_shared());
+        if (inflight > nchecked) {
+                inflight = nchecked;
+        }
+        if (inflight > 1) {
+                run.mode.max_memory /= inflight;
+        }
+        threadpool_run(threadpool_shared(), nchecked, run_job, &run);
+        for (unsigned t = 0; t < ncaught; t++) {
+                run_caught(&b->jobs[caught[t]], b->mode);
+        }
+        double wall = now() - start;
+
+        unsigned failed = 0;
+        uint64_t total = 0;
+        for (unsigned k = 0; k < b->njobs; k++) {
+                batch_job *job = &b->jobs[k];
+                if (job->error != NULL) {
+                        failed++;
+                } else {
+                        total += job->bytes;
+                }
+                if (report == NULL) {
+                        continue;
+                } else if (job->error != NULL) {
+                        fprintf(report, "%s: %s\n", job->input, job->error);
+                } else {
+                        fprintf(report, "%s -> %s: %llu bytes in %.3f s\n",
+                                job->input, job->output,
+                                (unsigned long long) job->bytes, 
+                                job->seconds);
+                }
+        }
+        if (report != NULL) {
+                fprintf(report, "%u files, %u failed, %llu bytes in %.3f s "
+                        "on %u threads\n", b->njobs, failed, 
+                        (unsigned long long) total, wall,
+                        threadpool_size(threadpool_shared()));
+        }
+
+        free(caught);
+        free(order);
+        return failed;
+}
+
+/**************************batch_free********************************
+ * 
+ * Parameters:
+ *      batch *b: pointer to the batch to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to a batch
+ * 
+ * *******************************************************************/
+void batch_free(batch *b)
+{
+        assert(b != NULL && *b != NULL);
+        for (unsigned k = 0; k < (*b)->njobs; k++) {
+                free((*b)->jobs[k].input);
+                free((*b)->jobs[k].output);
+        }
+        free((*b)->jobs);
+        free(*b);
+        *b = NULL;
+}
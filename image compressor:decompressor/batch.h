@@ -0,0 +1,135 @@
+/***********************************************************************
+ * 
+ *                      batch.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the interface to batch mode, which
+ *              compresses or decompresses many files in one process
+ * 
+ ***********************************************************************/
+#ifndef BATCH_INCLUDED
+#define BATCH_INCLUDED
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "compress40.h"
+
+/*one image of a batch*/
+typedef struct batch_job {
+        char *input;            /*path of the image to convert*/
+        char *output;           /*path the result is written to*/
+        uint64_t bytes;         /*size of the input, 0 until batch_run*/
+        double seconds;         /*time spent on the image*/
+        const char *error;      /*why the image was skipped, or NULL*/
+} batch_job;
+
+/*a list of images converted in the same direction by the same pipeline*/
+typedef struct batch {
+        compress40_mode mode;
+        const char *outdir;     /*directory of default outputs, or NULL*/
+        batch_job *jobs;
+        unsigned njobs;
+        unsigned capacity;
+} *batch;
+
+/**************************batch_new********************************
+ * 
+ * Parameters:
+ *      compress40_mode mode: direction and pipeline of every job
+ *      const char *outdir: directory the default output names are put
+ *              in, or NULL to put them next to their inputs
+ * 
+ * Return: 
+ *      a batch with no jobs
+ * 
+ * Expects: None
+ * 
+ * Notes: CRE is raised when malloc fails
+ * 
+ * *******************************************************************/
+extern batch batch_new(compress40_mode mode, const char *outdir);
+
+/**************************batch_add********************************
+ * 
+ * Parameters:
+ *      batch b: batch the job is added to
+ *      const char *input: path of the image to convert
+ *      const char *output: path of the result, or NULL for the default
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid batch and input
+ * 
+ * Notes: the default output name is the input name with a .ppm or .pnm
+ *      suffix (compressing) or a .c40 suffix (decompressing) replaced
+ *      by .c40 or .ppm, in outdir when the batch has one. Both paths
+ *      are copied. Inputs of the same name in different directories get
+ *      the same default output in outdir; batch_run fails all but the
+ *      first of them
+ * 
+ * *******************************************************************/
+extern void batch_add(batch b, const char *input, const char *output);
+
+/**************************batch_add_manifest********************************
+ * 
+ * Parameters:
+ *      batch b: batch the jobs are added to
+ *      FILE *manifest: open manifest file
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid batch and file pointer
+ * 
+ * Notes: every line of the manifest names one input, optionally followed
+ *      by whitespace and its output. Blank lines and lines starting with
+ *      # are skipped. Paths may not contain whitespace
+ * 
+ * *******************************************************************/
+extern void batch_add_manifest(batch b, FILE *manifest);
+
+/**************************batch_run********************************
+ * 
+ * Parameters:
+ *      batch b: batch to run
+ *      FILE *report: stream the per-file timing report is printed to,
+ *              or NULL for no report
+ * 
+ * Return: 
+ *      the number of jobs that could not be run
+ * 
+ * Expects: valid batch
+ * 
+ * Notes: the jobs are handed to the threads of the shared thread pool
+ *      one at a time, largest input first, so a thread that finishes
+ *      early takes the next job and big and small images balance out.
+ *      A job whose input or output cannot be opened is skipped and
+ *      reported, and so is a job whose output path is also the output of
+ *      a job added before it. An invalid or truncated image fails its
+ *      own job with the reason of the exception, and its partial output
+ *      is removed; images that can only be checked as they are read (P3,
+ *      input that is not a regular file, and every image compressed with
+ *      -s or -b) are converted one at a time after the others to allow
+ *      that. The report has one line per job, in the order they were
+ *      added, and a total
+ * 
+ * *******************************************************************/
+extern unsigned batch_run(batch b, FILE *report);
+
+/**************************batch_free********************************
+ * 
+ * Parameters:
+ *      batch *b: pointer to the batch to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to a batch
+ * 
+ * *******************************************************************/
+extern void batch_free(batch *b);
+
+#endif
@@ -0,0 +1,62 @@
+#!/bin/sh
+#
+#                       batchtest.sh
+#       Assignment: Arith
+#       Authors: Mishona Horton and Perucy Mussiba
+#       Date: 10/18/2026
+#       Purpose: Tests batch mode with bad images in the middle of the
+#               list: a truncated copy of flowers.ppm and a file that is
+#               not an image. They must fail on their own, leave no
+#               output behind, and not stop the images around them.
+#               Two inputs of the same name must not share an output.
+#               Run from this directory after building 40image, or with
+#               make test.
+#
+
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+status=0
+
+fail()
+{
+        echo "batchtest: $1" >&2
+        status=1
+}
+
+cp flowers.ppm "$dir/first.ppm"
+cp flowers.ppm "$dir/last.ppm"
+head -c 3000 flowers.ppm > "$dir/short.ppm"
+echo "not an image" > "$dir/junk.ppm"
+mkdir "$dir/out"
+
+./40image -c -j 2 -B "$dir/out" "$dir/first.ppm" "$dir/short.ppm" \
+        "$dir/junk.ppm" "$dir/last.ppm" 2> "$dir/report"
+if [ $? -eq 0 ]; then
+        fail "exit status does not show the failures"
+fi
+if ! grep -q "^4 files, 2 failed" "$dir/report"; then
+        fail "report does not count every image"
+fi
+for name in first last; do
+        ./40image -c flowers.ppm | cmp -s - "$dir/out/$name.c40" ||
+                fail "$name.c40 differs from a single run"
+done
+for name in short junk; do
+        grep -q "^$dir/$name.ppm: " "$dir/report" ||
+                fail "$name.ppm has no error in the report"
+        [ ! -e "$dir/out/$name.c40" ] || fail "$name.c40 was left behind"
+done
+
+mkdir "$dir/again"
+cp flowers.ppm "$dir/again/first.ppm"
+./40image -c -B "$dir/out" "$dir/first.ppm" "$dir/again/first.ppm" \
+        2> "$dir/report2"
+grep -q "^$dir/again/first.ppm: " "$dir/report2" ||
+        fail "two images were written to the same output"
+
+if [ $status -ne 0 ]; then
+        cat "$dir/report" >&2
+else
+        echo "batchtest: ok"
+fi
+exit $status
@@ -0,0 +1,298 @@
+/***********************************************************************
+ *
+ *                      bitpackrow.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements packing and unpacking of whole
+ *              arrays of 32-bit words, one array per field, with SIMD
+ *              versions picked at run time.
+ *
+ *              Every field is one mask and one shift each way, so the
+ *              kernels handle four (SSE2) or eight (AVX2) words per
+ *              instruction and finish the last few words with the scalar
+ *              code.
+ *
+ ***********************************************************************/
+#include "assert.h"
+#include "bitpackrow.h"
+#include "simd.h"
+
+/*the low width bits set, for a width from 1 to 32*/
+static inline uint32_t field_mask(unsigned width)
+{
+        return width < 32 ? ((uint32_t) 1 << width) - 1 : ~(uint32_t) 0;
+}
+
+/*checks the layout of a word; the fields must lie inside 32 bits*/
+static void check_fields(const bitfield *fields, unsigned nfields)
+{
+        assert(fields != NULL);
+        for (unsigned f = 0; f < nfields; f++) {
+                assert(fields[f].width >= 1 && fields[f].width <= 32);
+                assert(fields[f].lsb + fields[f].width <= 32);
+        }
+}
+
+/**************************pack_scalar********************************
+ *
+ * Parameters: see bitpackrow_pack; words first to n - 1 are packed
+ *
+ * Notes: portable version, one word at a time
+ *
+ * *******************************************************************/
+static void pack_scalar(const bitfield *fields, unsigned nfields,
+        const int32_t *const *values, unsigned first, unsigned n,
+        uint32_t *words)
+{
+        for (unsigned k = first; k < n; k++) {
+                uint32_t word = 0;
+                for (unsigned f = 0; f < nfields; f++) {
+                        word |= ((uint32_t) values[f][k] &
+                                 field_mask(fields[f].width)) <<
+                                fields[f].lsb;
+                }
+                words[k] = word;
+        }
+}
+
+/**************************unpack_scalar********************************
+ *
+ * Parameters: see bitpackrow_unpack; words first to n - 1 are unpacked
+ *
+ * Notes: portable version, one field at a time. A signed field is sign
+ *      extended by bitpackrow_signext, the same rule codeword_gets uses
+ *
+ * *******************************************************************/
+static void unpack_scalar(const bitfield *fields, unsigned nfields,
+        const uint32_t *words, unsigned first, unsigned n,
+        int32_t *const *values)
+{
+        for (unsigned f = 0; f < nfields; f++) {
+                unsigned width = fields[f].width, lsb = fields[f].lsb;
+                int32_t *out = values[f];
+
+                uint32_t mask = field_mask(width);
+                if (fields[f].is_signed) {
+                        for (unsigned k = first; k < n; k++)
+                                out[k] = bitpackrow_signext((words[k] >> 
+                                        lsb) & mask, width);
+                } else {
+                        for (unsigned k = first; k < n; k++)
+                                out[k] = (int32_t) ((words[k] >> lsb) &
+                                        mask);
+                }
+        }
+}
+
+#if SIMD_X86
+/**************************pack_sse2********************************
+ *
+ * Parameters: see bitpackrow_pack
+ *
+ * Notes: four words at a time
+ *
+ * *******************************************************************/
+static void pack_sse2(const bitfield *fields, unsigned nfields,
+        const int32_t *const *values, unsigned n, uint32_t *words)
+{
+        unsigned k = 0;
+
+        for (; k + 4 <= n; k += 4) {
+                __m128i word = _mm_setzero_si128();
+                for (unsigned f = 0; f < nfields; f++) {
+                        __m128i v = _mm_loadu_si128((const __m128i *)
+                                &values[f][k]);
+                        v = _mm_and_si128(v, _mm_set1_epi32((int32_t)
+                                field_mask(fields[f].width)));
+                        v = _mm_sll_epi32(v, _mm_cvtsi32_si128((int)
+                                fields[f].lsb));
+                        word = _mm_or_si128(word, v);
+                }
+                _mm_storeu_si128((__m128i *) &words[k], word);
+        }
+        pack_scalar(fields, nfields, values, k, n, words);
+}
+
+/**************************unpack_sse2********************************
+ *
+ * Parameters: see bitpackrow_unpack
+ *
+ * Notes: four words at a time
+ *
+ * *******************************************************************/
+static void unpack_sse2(const bitfield *fields, unsigned nfields,
+        const uint32_t *words, unsigned n, int32_t *const *values)
+{
+        unsigned k = 0;
+
+        for (; k + 4 <= n; k += 4) {
+                __m128i word = _mm_loadu_si128((const __m128i *) &words[k]);
+                for (unsigned f = 0; f < nfields; f++) {
+                        unsigned width = fields[f].width;
+                        unsigned lsb = fields[f].lsb;
+                        __m128i v;
+
+                        if (fields[f].is_signed) {
+                                v = _mm_sll_epi32(word, _mm_cvtsi32_si128(
+                                        (int) (32 - width - lsb)));
+                                v = _mm_sra_epi32(v, _mm_cvtsi32_si128(
+                                        (int) (32 - width)));
+                        } else {
+                                v = _mm_srl_epi32(word,
+                                        _mm_cvtsi32_si128((int) lsb));
+                                v = _mm_and_si128(v, _mm_set1_epi32(
+                                        (int32_t) field_mask(width)));
+                        }
+                        _mm_storeu_si128((__m128i *) &values[f][k], v);
+                }
+        }
+        unpack_scalar(fields, nfields, words, k, n, values);
+}
+
+/**************************pack_avx2********************************
+ *
+ * Parameters: see bitpackrow_pack
+ *
+ * Notes: eight words at a time
+ *
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static void pack_avx2(const bitfield *fields, unsigned nfields,
+        const int32_t *const *values, unsigned n, uint32_t *words)
+{
+        unsigned k = 0;
+
+        for (; k + 8 <= n; k += 8) {
+                __m256i word = _mm256_setzero_si256();
+                for (unsigned f = 0; f < nfields; f++) {
+                        __m256i v = _mm256_loadu_si256((const __m256i *)
+                                &values[f][k]);
+                        v = _mm256_and_si256(v, _mm256_set1_epi32((int32_t)
+                                field_mask(fields[f].width)));
+                        v = _mm256_sll_epi32(v, _mm_cvtsi32_si128((int)
+                                fields[f].lsb));
+                        word = _mm256_or_si256(word, v);
+                }
+                _mm256_storeu_si256((__m256i *) &words[k], word);
+        }
+        pack_scalar(fields, nfields, values, k, n, words);
+}
+
+/**************************unpack_avx2********************************
+ *
+ * Parameters: see bitpackrow_unpack
+ *
+ * Notes: eight words at a time
+ *
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static void unpack_avx2(const bitfield *fields, unsigned nfields,
+        const uint32_t *words, unsigned n, int32_t *const *values)
+{
+        unsigned k = 0;
+
+        for (; k + 8 <= n; k += 8) {
+                __m256i word = _mm256_loadu_si256((const __m256i *)
+                        &words[k]);
+                for (unsigned f = 0; f < nfields; f++) {
+                        unsigned width = fields[f].width;
+                        unsigned lsb = fields[f].lsb;
+                        __m256i v;
+
+                        if (fields[f].is_signed) {
+                                v = _mm256_sll_epi32(word, _mm_cvtsi32_si128(
+                                        (int) (32 - width - lsb)));
+                                v = _mm256_sra_epi32(v, _mm_cvtsi32_si128(
+                                        (int) (32 - width)));
+                        } else {
+                                v = _mm256_srl_epi32(word,
+                                        _mm_cvtsi32_si128((int) lsb));
+                                v = _mm256_and_si256(v, _mm256_set1_epi32(
+                                        (int32_t) field_mask(width)));
+                        }
+                        _mm256_storeu_si256((__m256i *) &values[f][k], v);
+                }
+        }
+        unpack_scalar(fields, nfields, words, k, n, values);
+}
+#endif
+
+/**************************bitpackrow_pack********************************
+ *
+ * Parameters:
+ *      const bitfield *fields: layout of the word, nfields fields
+ *      unsigned nfields: number of fields
+ *      const int32_t *const *values: one array of n values per field
+ *      unsigned n: number of words
+ *      uint32_t *words: n words to be filled in
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid arrays, fields from 1 to 32 bits wide that lie inside
+ *      the word and do not overlap
+ *
+ * Notes: CRE is raised when a field does not lie inside the word.
+ *      Dispatches to the best kernel for the cpu
+ *
+ * *******************************************************************/
+void bitpackrow_pack(const bitfield *fields, unsigned nfields,
+        const int32_t *const *values, unsigned n, uint32_t *words)
+{
+        check_fields(fields, nfields);
+        assert(values != NULL && words != NULL);
+#if SIMD_X86
+        switch (simd_detect()) {
+        case SIMD_AVX2:
+                pack_avx2(fields, nfields, values, n, words);
+                return;
+        case SIMD_SSE2:
+                pack_sse2(fields, nfields, values, n, words);
+                return;
+        default:
+                break;
+        }
+#endif
+        pack_scalar(fields, nfields, values, 0, n, words);
+}
+
+/**************************bitpackrow_unpack********************************
+ *
+ * Parameters:
+ *      const bitfield *fields: layout of the word, nfields fields
+ *      unsigned nfields: number of fields
+ *      const uint32_t *words: n words
+ *      unsigned n: number of words
+ *      int32_t *const *values: one array of n values per field to be
+ *              filled in
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid arrays, fields from 1 to 32 bits wide that lie inside
+ *      the word
+ *
+ * Notes: CRE is raised when a field does not lie inside the word.
+ *      Dispatches to the best kernel for the cpu
+ *
+ * *******************************************************************/
+void bitpackrow_unpack(const bitfield *fields, unsigned nfields,
+        const uint32_t *words, unsigned n, int32_t *const *values)
+{
+        check_fields(fields, nfields);
+        assert(values != NULL && words != NULL);
+#if SIMD_X86
+        switch (simd_detect()) {
+        case SIMD_AVX2:
+                unpack_avx2(fields, nfields, words, n, values);
+                return;
+        case SIMD_SSE2:
+                unpack_sse2(fields, nfields, words, n, values);
+                return;
+        default:
+                break;
+        }
+#endif
+        unpack_scalar(fields, nfields, words, 0, n, values);
+}
@@ -0,0 +1,94 @@
+/***********************************************************************
+ *
+ *                      bitpackrow.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains function and struct declarations for
+ *              bitpackrow.c
+ *
+ ***********************************************************************/
+#ifndef BITPACKROW_INCLUDED
+#define BITPACKROW_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*one field of a 32-bit word: width bits starting at bit lsb, holding a
+ two's complement value when is_signed*/
+typedef struct bitfield {
+        unsigned width;
+        unsigned lsb;
+        bool is_signed;
+} bitfield;
+
+/**************************bitpackrow_signext********************************
+ *
+ * Parameters:
+ *      uint32_t field: a field moved down to bit 0, with nothing above it
+ *      unsigned width: width of the field in bits, from 1 to 32
+ *
+ * Return:
+ *      the field read as a two's complement number of width bits
+ *
+ * Expects: field below 2^width
+ *
+ * Notes: flipping the sign bit and subtracting its weight extends the
+ *      sign with arithmetic alone, so unlike a right shift of a negative
+ *      int the result does not depend on the compiler
+ *
+ * *******************************************************************/
+static inline int32_t bitpackrow_signext(uint32_t field, unsigned width)
+{
+        int64_t sign = (int64_t) 1 << (width - 1);
+        return (int32_t) ((int64_t) (field ^ (uint32_t) sign) - sign);
+}
+
+/**************************bitpackrow_pack********************************
+ *
+ * Parameters:
+ *      const bitfield *fields: layout of the word, nfields fields
+ *      unsigned nfields: number of fields
+ *      const int32_t *const *values: one array of n values per field,
+ *              in the order of fields
+ *      unsigned n: number of words
+ *      uint32_t *words: n words to be filled in
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid arrays, fields from 1 to 32 bits wide that lie inside
+ *      the word and do not overlap
+ *
+ * Notes: word k holds value k of every field. A value is cut to the
+ *      width of its field, so it never reaches its neighbours. Uses AVX2
+ *      or SSE2 when the cpu has them
+ *
+ * *******************************************************************/
+extern void bitpackrow_pack(const bitfield *fields, unsigned nfields,
+        const int32_t *const *values, unsigned n, uint32_t *words);
+
+/**************************bitpackrow_unpack********************************
+ *
+ * Parameters:
+ *      const bitfield *fields: layout of the word, nfields fields
+ *      unsigned nfields: number of fields
+ *      const uint32_t *words: n words
+ *      unsigned n: number of words
+ *      int32_t *const *values: one array of n values per field to be
+ *              filled in, in the order of fields
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid arrays, fields from 1 to 32 bits wide that lie inside
+ *      the word
+ *
+ * Notes: a signed field is sign extended and an unsigned one is zero
+ *      extended. Uses AVX2 or SSE2 when the cpu has them
+ *
+ * *******************************************************************/
+extern void bitpackrow_unpack(const bitfield *fields, unsigned nfields,
+        const uint32_t *words, unsigned n, int32_t *const *values);
+
+#endif
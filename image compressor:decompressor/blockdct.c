@@ -0,0 +1,298 @@
+/***********************************************************************
+ * 
+ *                      blockdct.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements the discrete cosine transform and
+ *              quantization of a whole row of 2 by 2 blocks, with SIMD
+ *              versions picked at run time.
+ * 
+ *              The kernels are bit-exact with codec40.h: the float sums
+ *              are formed in the same order, dividing by 4 is done as an
+ *              exact multiply by 0.25, the +-0.3 clamp uses min/max with
+ *              the limit as the first operand, and the scaling by 511 and
+ *              31 is done in double precision before truncation, just as
+ *              the scalar casts do.
+ * 
+ ***********************************************************************/
+#include "blockdct.h"
+#include "codec40.h"
+#include "simd.h"
+
+/**************************blockdct_forward_scalar*****************************
+ * 
+ * Parameters: see blockdct_forward
+ * 
+ * Notes: portable version, one block at a time
+ * 
+ * *******************************************************************/
+static void blockdct_forward_scalar(vcs_rows in, unsigned nblocks,
+        dct_row out)
+{
+        for (unsigned c = 0; c < nblocks; c++) {
+                unsigned l = 2 * c, r = 2 * c + 1;
+                struct bitword bit;
+
+                block_luma(in.y[0][l], in.y[0][r], in.y[1][l], in.y[1][r],
+                        &bit);
+                out.a[c] = (int32_t) bit.a;
+                out.b[c] = (int32_t) bit.b;
+                out.c[c] = (int32_t) bit.c;
+                out.d[c] = (int32_t) bit.d;
+                out.avpb[c] = block_chroma(in.pb[0][l], in.pb[0][r],
+                        in.pb[1][l], in.pb[1][r]);
+                out.avpr[c] = block_chroma(in.pr[0][l], in.pr[0][r],
+                        in.pr[1][l], in.pr[1][r]);
+        }
+}
+
+/*advances every pointer of a vcs_rows or dct_row by k blocks*/
+static vcs_rows vcs_rows_skip(vcs_rows in, unsigned k)
+{
+        for (int r = 0; r < 2; r++) {
+                in.y[r] += 2 * k;
+                in.pb[r] += 2 * k;
+                in.pr[r] += 2 * k;
+        }
+        return in;
+}
+
+static dct_row dct_row_skip(dct_row out, unsigned k)
+{
+        out.a += k;
+        out.b += k;
+        out.c += k;
+        out.d += k;
+        out.avpb += k;
+        out.avpr += k;
+        return out;
+}
+
+#if SIMD_X86
+/**************************split_sse2********************************
+ * 
+ * Parameters:
+ *      const float *row: eight consecutive values of a pixel row
+ *      __m128 *left: set to the values of the left pixels of 4 blocks
+ *      __m128 *right: set to the values of the right pixels
+ * 
+ * *******************************************************************/
+static inline void split_sse2(const float *row, __m128 *left, __m128 *right)
+{
+        __m128 v0 = _mm_loadu_ps(row);
+        __m128 v1 = _mm_loadu_ps(row + 4);
+        *left = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        *right = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+/**************************scale_sse2********************************
+ * 
+ * Parameters:
+ *      __m128 v: four coefficients
+ *      double scale: 511.0 for a, 31.0 for b, c and d
+ * 
+ * Return: 
+ *      (int) (v * scale) computed in double precision
+ * 
+ * *******************************************************************/
+static inline __m128i scale_sse2(__m128 v, double scale)
+{
+        __m128d s = _mm_set1_pd(scale);
+        __m128i lo = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(v), s));
+        __m128i hi = _mm_cvttpd_epi32(_mm_mul_pd(
+                _mm_cvtps_pd(_mm_movehl_ps(v, v)), s));
+        return _mm_unpacklo_epi64(lo, hi);
+}
+
+/**************************blockdct_forward_sse2*******************************
+ * 
+ * Parameters: see blockdct_forward
+ * 
+ * Notes: four blocks per iteration
+ * 
+ * *******************************************************************/
+static void blockdct_forward_sse2(vcs_rows in, unsigned nblocks, dct_row out)
+{
+        const __m128 quarter = _mm_set1_ps(0.25f);
+        const __m128 lo = _mm_set1_ps(-0.3f);
+        const __m128 hi = _mm_set1_ps(0.3f);
+        unsigned c = 0;
+
+        for (; c + 4 <= nblocks; c += 4) {
+                __m128 y1, y2, y3, y4, p1, p2, p3, p4;
+                unsigned k = 2 * c;
+
+                split_sse2(&in.y[0][k], &y1, &y2);
+                split_sse2(&in.y[1][k], &y3, &y4);
+
+                __m128 s43 = _mm_add_ps(y4, y3);
+                __m128 d43 = _mm_sub_ps(y4, y3);
+                __m128 fa = _mm_add_ps(_mm_add_ps(s43, y2), y1);
+                __m128 fb = _mm_sub_ps(_mm_sub_ps(s43, y2), y1);
+                __m128 fc = _mm_sub_ps(_mm_add_ps(d43, y2), y1);
+                __m128 fd = _mm_add_ps(_mm_sub_ps(d43, y2), y1);
+
+                fa = _mm_mul_ps(fa, quarter);
+                fb = _mm_min_ps(hi, _mm_max_ps(lo, _mm_mul_ps(fb, quarter)));
+                fc = _mm_min_ps(hi, _mm_max_ps(lo, _mm_mul_ps(fc, quarter)));
+                fd = _mm_min_ps(hi, _mm_max_ps(lo, _mm_mul_ps(fd, quarter)));
+
+                _mm_storeu_si128((__m128i *) &out.a[c], scale_sse2(fa, 511.0));
+                _mm_storeu_si128((__m128i *) &out.b[c], scale_sse2(fb, 31.0));
+                _mm_storeu_si128((__m128i *) &out.c[c], scale_sse2(fc, 31.0));
+                _mm_storeu_si128((__m128i *) &out.d[c], scale_sse2(fd, 31.0));
+
+                split_sse2(&in.pb[0][k], &p1, &p2);
+                split_sse2(&in.pb[1][k], &p3, &p4);
+                _mm_storeu_ps(&out.avpb[c], _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+                        _mm_add_ps(p1, p2), p3), p4), quarter));
+
+                split_sse2(&in.pr[0][k], &p1, &p2);
+                split_sse2(&in.pr[1][k], &p3, &p4);
+                _mm_storeu_ps(&out.avpr[c], _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+                        _mm_add_ps(p1, p2), p3), p4), quarter));
+        }
+        blockdct_forward_scalar(vcs_rows_skip(in, c), nblocks - c,
+                dct_row_skip(out, c));
+}
+
+/**************************split_avx2********************************
+ * 
+ * Parameters:
+ *      const float *row: sixteen consecutive values of a pixel row
+ *      __m256 *left: set to the values of the left pixels of 8 blocks
+ *      __m256 *right: set to the values of the right pixels
+ * 
+ * Notes: the in-lane shuffles leave the blocks in the order 0 1 4 5
+ *      2 3 6 7; a cross-lane permute puts them back in order
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static inline void split_avx2(const float *row, __m256 *left, __m256 *right)
+{
+        __m256 v0 = _mm256_loadu_ps(row);
+        __m256 v1 = _mm256_loadu_ps(row + 8);
+        __m256 l = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 r = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        *left = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l),
+                _MM_SHUFFLE(3, 1, 2, 0)));
+        *right = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r),
+                _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+/**************************scale_avx2********************************
+ * 
+ * Parameters:
+ *      __m256 v: eight coefficients
+ *      double scale: 511.0 for a, 31.0 for b, c and d
+ * 
+ * Return: 
+ *      (int) (v * scale) computed in double precision
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static inline __m256i scale_avx2(__m256 v, double scale)
+{
+        __m256d s = _mm256_set1_pd(scale);
+        __m128i lo = _mm256_cvttpd_epi32(_mm256_mul_pd(
+                _mm256_cvtps_pd(_mm256_castps256_ps128(v)), s));
+        __m128i hi = _mm256_cvttpd_epi32(_mm256_mul_pd(
+                _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)), s));
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+/**************************blockdct_forward_avx2*******************************
+ * 
+ * Parameters: see blockdct_forward
+ * 
+ * Notes: eight blocks per iteration
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static void blockdct_forward_avx2(vcs_rows in, unsigned nblocks, dct_row out)
+{
+        const __m256 quarter = _mm256_set1_ps(0.25f);
+        const __m256 lo = _mm256_set1_ps(-0.3f);
+        const __m256 hi = _mm256_set1_ps(0.3f);
+        unsigned c = 0;
+
+        for (; c + 8 <= nblocks; c += 8) {
+                __m256 y1, y2, y3, y4, p1, p2, p3, p4;
+                unsigned k = 2 * c;
+
+                split_avx2(&in.y[0][k], &y1, &y2);
+                split_avx2(&in.y[1][k], &y3, &y4);
+
+                __m256 s43 = _mm256_add_ps(y4, y3);
+                __m256 d43 = _mm256_sub_ps(y4, y3);
+                __m256 fa = _mm256_add_ps(_mm256_add_ps(s43, y2), y1);
+                __m256 fb = _mm256_sub_ps(_mm256_sub_ps(s43, y2), y1);
+                __m256 fc = _mm256_sub_ps(_mm256_add_ps(d43, y2), y1);
+                __m256 fd = _mm256_add_ps(_mm256_sub_ps(d43, y2), y1);
+
+                fa = _mm256_mul_ps(fa, quarter);
+                fb = _mm256_min_ps(hi, _mm256_max_ps(lo,
+                        _mm256_mul_ps(fb, quarter)));
+                fc = _mm256_min_ps(hi, _mm256_max_ps(lo,
+                        _mm256_mul_ps(fc, quarter)));
+                fd = _mm256_min_ps(hi, _mm256_max_ps(lo,
+                        _mm256_mul_ps(fd, quarter)));
+
+                _mm256_storeu_si256((__m256i *) &out.a[c],
+                        scale_avx2(fa, 511.0));
+                _mm256_storeu_si256((__m256i *) &out.b[c],
+                        scale_avx2(fb, 31.0));
+                _mm256_storeu_si256((__m256i *) &out.c[c],
+                        scale_avx2(fc, 31.0));
+                _mm256_storeu_si256((__m256i *) &out.d[c],
+                        scale_avx2(fd, 31.0));
+
+                split_avx2(&in.pb[0][k], &p1, &p2);
+                split_avx2(&in.pb[1][k], &p3, &p4);
+                _mm256_storeu_ps(&out.avpb[c], _mm256_mul_ps(_mm256_add_ps(
+                        _mm256_add_ps(_mm256_add_ps(p1, p2), p3), p4),
+                        quarter));
+
+                split_avx2(&in.pr[0][k], &p1, &p2);
+                split_avx2(&in.pr[1][k], &p3, &p4);
+                _mm256_storeu_ps(&out.avpr[c], _mm256_mul_ps(_mm256_add_ps(
+                        _mm256_add_ps(_mm256_add_ps(p1, p2), p3), p4),
+                        quarter));
+        }
+        blockdct_forward_sse2(vcs_rows_skip(in, c), nblocks - c,
+                dct_row_skip(out, c));
+}
+#endif
+
+/**************************blockdct_forward********************************
+ * 
+ * Parameters:
+ *      vcs_rows in: two pixel rows of at least 2 * nblocks pixels each
+ *      unsigned nblocks: number of 2 by 2 blocks in the row
+ *      dct_row out: arrays of nblocks elements to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arrays
+ * 
+ * Notes: dispatches to the best kernel for the cpu
+ * 
+ * *******************************************************************/
+void blockdct_forward(vcs_rows in, unsigned nblocks, dct_row out)
+{
+#if SIMD_X86
+        switch (simd_detect()) {
+        case SIMD_AVX2:
+                blockdct_forward_avx2(in, nblocks, out);
+                return;
+        case SIMD_SSE2:
+                blockdct_forward_sse2(in, nblocks, out);
+                return;
+        default:
+                break;
+        }
+#endif
+        blockdct_forward_scalar(in, nblocks, out);
+}
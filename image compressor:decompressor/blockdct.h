@@ -0,0 +1,56 @@
+/***********************************************************************
+ * 
+ *                      blockdct.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains function and struct declarations for
+ *              blockdct.c
+ * 
+ ***********************************************************************/
+#ifndef BLOCKDCT_INCLUDED
+#define BLOCKDCT_INCLUDED
+
+#include <stdint.h>
+
+/*the two pixel rows of a block row as planar component video; row 0 is
+ the top row*/
+typedef struct vcs_rows {
+        const float *y[2];
+        const float *pb[2];
+        const float *pr[2];
+} vcs_rows;
+
+/*the quantized cosine coefficients and the (not yet quantized) chroma
+ averages of a row of blocks, one array per field*/
+typedef struct dct_row {
+        int32_t *a;
+        int32_t *b;
+        int32_t *c;
+        int32_t *d;
+        float *avpb;
+        float *avpr;
+} dct_row;
+
+/**************************blockdct_forward********************************
+ * 
+ * Parameters:
+ *      vcs_rows in: two pixel rows of at least 2 * nblocks pixels each
+ *      unsigned nblocks: number of 2 by 2 blocks in the row
+ *      dct_row out: arrays of nblocks elements to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arrays
+ * 
+ * Notes: computes the butterflies for a, b, c and d of every block,
+ *      clamps b, c and d to [-0.3, 0.3], scales a by 511 and b, c, d by
+ *      31 and truncates, and averages pb and pr. Uses AVX2 or SSE2 when
+ *      the cpu has them; the values are identical to the ones computed
+ *      by block_luma and block_chroma in codec40.h
+ * 
+ * *******************************************************************/
+extern void blockdct_forward(vcs_rows in, unsigned nblocks, dct_row out);
+
+#endif
@@ -0,0 +1,139 @@
+/***********************************************************************
+ * 
+ *                      blockrow.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements the fused kernels that convert one
+ *              row of 2 by 2 blocks between rgb pixels and code words
+ * 
+ ***********************************************************************/
+#include "blockrow.h"
+#include "blockdct.h"
+#include "chroma40.h"
+#include "codec40.h"
+#include "colorconv.h"
+
+/*blocks handled per pass; the planar buffers of a pass fit in L1*/
+#define CHUNK 128
+
+/**************************blockrow_compress********************************
+ * 
+ * Parameters:
+ *      const unsigned char *top: first pixel row of the block row, as
+ *              P6 samples
+ *      const unsigned char *bottom: second pixel row of the block row
+ *      unsigned nblocks: number of 2 by 2 blocks in the block row
+ *      unsigned denominator: maximum value of an rgb component
+ *      uint32_t *words: array of nblocks code words to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: both rows hold at least 2 * nblocks pixels
+ * 
+ * Notes: the block row is handled CHUNK blocks at a time. Both pixel rows
+ *      of a chunk are converted straight from the raster to planar y, pb
+ *      and pr by the vectorized rawrow_to_vcs into buffers small enough
+ *      to stay in the L1 cache, blockdct_forward computes the
+ *      coefficients of the whole chunk, chroma_index_row quantizes its
+ *      chroma averages, and bitpackrow_pack packs the chunk, with the
+ *      same arithmetic as the staged pipeline
+ * 
+ * *******************************************************************/
+void blockrow_compress(const unsigned char *top,
+        const unsigned char *bottom, unsigned nblocks, unsigned denominator,
+        uint32_t *words)
+{
+        float y[2][2 * CHUNK], pb[2][2 * CHUNK], pr[2][2 * CHUNK];
+        int32_t a[CHUNK], b[CHUNK], c[CHUNK], d[CHUNK];
+        float avpb[CHUNK], avpr[CHUNK];
+        uint32_t pbindex[CHUNK], prindex[CHUNK];
+        vcs_rows in = { { y[0], y[1] }, { pb[0], pb[1] }, { pr[0], pr[1] } };
+        dct_row out = { a, b, c, d, avpb, avpr };
+        const int32_t *fields[CODEWORD_NFIELDS] = {
+                [CODEWORD_a] = a, [CODEWORD_b] = b, [CODEWORD_c] = c,
+                [CODEWORD_d] = d, [CODEWORD_av_pb] = (int32_t *) pbindex,
+                [CODEWORD_av_pr] = (int32_t *) prindex
+        };
+        unsigned step = raw_pixelbytes(denominator);
+
+        for (unsigned c0 = 0; c0 < nblocks; c0 += CHUNK) {
+                unsigned n = (nblocks - c0 < CHUNK) ? nblocks - c0 : CHUNK;
+
+                size_t offset = (size_t) 2 * c0 * step;
+
+                rawrow_to_vcs(&top[offset], 2 * n, denominator, y[0], pb[0],
+                        pr[0]);
+                rawrow_to_vcs(&bottom[offset], 2 * n, denominator, y[1], 
+                        pb[1], pr[1]);
+                blockdct_forward(in, n, out);
+                chroma_index_row(avpb, n, pbindex);
+                chroma_index_row(avpr, n, prindex);
+
+                bitpackrow_pack(codeword_layout, CODEWORD_NFIELDS, fields, n,
+                        &words[c0]);
+        }
+}
+/**************************blockrow_decompress********************************
+ * 
+ * Parameters:
+ *      const uint32_t *words: one row of nblocks code words
+ *      unsigned nblocks: number of 2 by 2 blocks in the block row
+ *      unsigned char *top: first P6 scanline of the block row
+ *      unsigned char *bottom: second P6 scanline of the block row
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: both scanlines hold at least 6 * nblocks bytes
+ * 
+ * Notes: the block row is handled CHUNK blocks at a time. The words of
+ *      a chunk are unpacked by bitpackrow_unpack, every block is
+ *      inverse-transformed into planar y, pb and pr buffers small enough
+ *      to stay in the L1 cache, then each of the two pixel rows is
+ *      converted to rgb bytes by the vectorized vcsrow_to_rgb, using the
+ *      same arithmetic as the staged pipeline
+ * 
+ * *******************************************************************/
+void blockrow_decompress(const uint32_t *words, unsigned nblocks,
+        unsigned char *top, unsigned char *bottom)
+{
+        float y[2][2 * CHUNK], pb[2][2 * CHUNK], pr[2][2 * CHUNK];
+        int32_t field[CODEWORD_NFIELDS][CHUNK];
+        int32_t *fields[CODEWORD_NFIELDS];
+
+        for (int f = 0; f < CODEWORD_NFIELDS; f++)
+                fields[f] = field[f];
+
+        for (unsigned c0 = 0; c0 < nblocks; c0 += CHUNK) {
+                unsigned n = (nblocks - c0 < CHUNK) ? nblocks - c0 : CHUNK;
+
+                bitpackrow_unpack(codeword_layout, CODEWORD_NFIELDS, 
+                        &words[c0], n, fields);
+
+                for (unsigned c = 0; c < n; c++) {
+                        struct color_space cs[4];
+                        struct bitword bit;
+
+                        bit.a = (uint64_t) field[CODEWORD_a][c];
+                        bit.b = field[CODEWORD_b][c];
+                        bit.c = field[CODEWORD_c][c];
+                        bit.d = field[CODEWORD_d][c];
+                        bit.av_pb = (uint64_t) field[CODEWORD_av_pb][c];
+                        bit.av_pr = (uint64_t) field[CODEWORD_av_pr][c];
+                        bitword_to_block(&bit, &cs[0], &cs[1], &cs[2], 
+                                &cs[3]);
+
+                        for (int k = 0; k < 4; k++) {
+                                unsigned row = k / 2, col = 2 * c + k % 2;
+                                y[row][col] = cs[k].y;
+                                pb[row][col] = cs[k].pb;
+                                pr[row][col] = cs[k].pr;
+                        }
+                }
+
+                vcsrow_to_rgb(y[0], pb[0], pr[0], 2 * n, &top[6 * c0]);
+                vcsrow_to_rgb(y[1], pb[1], pr[1], 2 * n, &bottom[6 * c0]);
+        }
+}
@@ -0,0 +1,63 @@
+/***********************************************************************
+ * 
+ *                      blockrow.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains function declarations for blockrow.c
+ * 
+ ***********************************************************************/
+#ifndef BLOCKROW_INCLUDED
+#define BLOCKROW_INCLUDED
+
+#include <stdint.h>
+#include "pnm.h"
+
+/**************************blockrow_compress********************************
+ * 
+ * Parameters:
+ *      const unsigned char *top: first pixel row of the block row, as
+ *              P6 samples
+ *      const unsigned char *bottom: second pixel row of the block row
+ *      unsigned nblocks: number of 2 by 2 blocks in the block row
+ *      unsigned denominator: maximum value of an rgb component
+ *      uint32_t *words: array of nblocks code words to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: both rows hold at least 2 * nblocks pixels
+ * 
+ * Notes: fuses the color transform, the discrete cosine transform,
+ *      quantization and bitpacking of every block in the row so no
+ *      intermediate image is built. The code words are identical to the
+ *      ones made by the staged pipeline
+ * 
+ * *******************************************************************/
+extern void blockrow_compress(const unsigned char *top,
+        const unsigned char *bottom, unsigned nblocks, unsigned denominator,
+        uint32_t *words);
+
+/**************************blockrow_decompress********************************
+ * 
+ * Parameters:
+ *      const uint32_t *words: one row of nblocks code words
+ *      unsigned nblocks: number of 2 by 2 blocks in the block row
+ *      unsigned char *top: first P6 scanline of the block row
+ *      unsigned char *bottom: second P6 scanline of the block row
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: both scanlines hold at least 6 * nblocks bytes
+ * 
+ * Notes: fuses unpacking, the inverse cosine transform and the conversion
+ *      to rgb of every block in the row. The scanlines hold interleaved
+ *      r, g, b bytes for a denominator of 255, identical to the pixels
+ *      made by the staged pipeline
+ * 
+ * *******************************************************************/
+extern void blockrow_decompress(const uint32_t *words, unsigned nblocks,
+        unsigned char *top, unsigned char *bottom);
+
+#endif
@@ -0,0 +1,234 @@
+/***********************************************************************
+ * 
+ *                      chroma40.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file builds the chroma quantization table and
+ *              implements the row quantizer.
+ * 
+ *              Arith40_index_of_chroma is a nondecreasing step function
+ *              of its argument, so it is fully described by the smallest
+ *              float at which each step up happens. Those are found by
+ *              bisection over the floats in order, calling the library,
+ *              and the index of x is then the number of thresholds that
+ *              x reaches. The result is identical to the library's for
+ *              every float, ties and out of range values included.
+ *              Since a sum of four integer chromas over 2^17 is exact in
+ *              float, rounding a threshold up to that grid keeps the
+ *              fixed-point indices exact too.
+ * 
+ ***********************************************************************/
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+#include "arith40.h"
+#include "chroma40.h"
+#include "simd.h"
+
+/*maps floats to unsigned keys that sort in the same order*/
+static uint32_t float_key(float f)
+{
+        uint32_t u;
+        memcpy(&u, &f, sizeof(u));
+        return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+static float key_float(uint32_t key)
+{
+        uint32_t u = (key & 0x80000000u) ? (key & 0x7fffffffu) : ~key;
+        float f;
+        memcpy(&f, &u, sizeof(f));
+        return f;
+}
+
+/**************************find_threshold********************************
+ * 
+ * Parameters:
+ *      unsigned k: a chroma index from 0 to 14
+ * 
+ * Return: 
+ *      the smallest finite float whose index is above k, or infinity
+ *      when there is none
+ * 
+ * *******************************************************************/
+static float find_threshold(unsigned k)
+{
+        uint32_t lo = float_key(-FLT_MAX);
+        uint32_t hi = float_key(FLT_MAX);
+
+        if (Arith40_index_of_chroma(-FLT_MAX) > k) {
+                return -INFINITY;
+        }
+        if (Arith40_index_of_chroma(FLT_MAX) <= k) {
+                return INFINITY;
+        }
+        /*index(lo) <= k < index(hi)*/
+        while (hi - lo > 1) {
+                uint32_t mid = lo + (hi - lo) / 2;
+                if (Arith40_index_of_chroma(key_float(mid)) > k) {
+                        hi = mid;
+                } else {
+                        lo = mid;
+                }
+        }
+        return key_float(hi);
+}
+
+/**************************sum_threshold********************************
+ * 
+ * Parameters:
+ *      float threshold: a threshold of the table
+ * 
+ * Return: 
+ *      the smallest integer s with s / 2^17 >= threshold, kept inside
+ *      the int32_t range
+ * 
+ * *******************************************************************/
+static int32_t sum_threshold(float threshold)
+{
+        double s = ceil((double) threshold * 131072.0);
+        if (s < INT32_MIN) {
+                return INT32_MIN;
+        } else if (s > INT32_MAX) {
+                return INT32_MAX;
+        }
+        return (int32_t) s;
+}
+
+static chroma_table table;
+
+/*fills in the table; run exactly once, by pthread_once*/
+static void build_table(void)
+{
+        for (unsigned k = 0; k < 15; k++) {
+                table.threshold[k] = find_threshold(k);
+                table.sum_threshold[k] = sum_threshold(table.threshold[k]);
+        }
+        for (unsigned i = 0; i < 16; i++) {
+                table.value[i] = Arith40_chroma_of_index(i);
+                table.q15_value[i] = (int32_t) lround(table.value[i] * 32768.0);
+        }
+}
+
+/**************************chroma_table_get********************************
+ * 
+ * Parameters: 
+ *      None
+ * 
+ * Return: 
+ *      the quantization table
+ * 
+ * Expects: None
+ * 
+ * Notes: the table is built once, on the first call, and it is safe
+ *      to call from several threads at a time
+ * 
+ * *******************************************************************/
+const chroma_table *chroma_table_get(void)
+{
+        static pthread_once_t once = PTHREAD_ONCE_INIT;
+        pthread_once(&once, build_table);
+        return &table;
+}
+
+/**************************chroma_index_row_scalar*****************************
+ * 
+ * Parameters: see chroma_index_row
+ * 
+ * *******************************************************************/
+static void chroma_index_row_scalar(const chroma_table *t, const float *avg,
+        unsigned n, uint32_t *index)
+{
+        for (unsigned i = 0; i < n; i++) {
+                index[i] = chroma_index(t, avg[i]);
+        }
+}
+
+#if SIMD_X86
+/**************************chroma_index_row_sse2*******************************
+ * 
+ * Parameters: see chroma_index_row
+ * 
+ * Notes: four averages per iteration; each compare gives -1 in the lanes
+ *      that reach the threshold, and the negated sum is the index
+ * 
+ * *******************************************************************/
+static void chroma_index_row_sse2(const chroma_table *t, const float *avg,
+        unsigned n, uint32_t *index)
+{
+        unsigned i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                __m128 x = _mm_loadu_ps(&avg[i]);
+                __m128i sum = _mm_setzero_si128();
+                for (int k = 0; k < 15; k++) {
+                        __m128 ge = _mm_cmpge_ps(x,
+                                _mm_set1_ps(t->threshold[k]));
+                        sum = _mm_sub_epi32(sum, _mm_castps_si128(ge));
+                }
+                _mm_storeu_si128((__m128i *) &index[i], sum);
+        }
+        chroma_index_row_scalar(t, &avg[i], n - i, &index[i]);
+}
+
+/**************************chroma_index_row_avx2*******************************
+ * 
+ * Parameters: see chroma_index_row
+ * 
+ * Notes: eight averages per iteration
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static void chroma_index_row_avx2(const chroma_table *t, const float *avg,
+        unsigned n, uint32_t *index)
+{
+        unsigned i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+                __m256 x = _mm256_loadu_ps(&avg[i]);
+                __m256i sum = _mm256_setzero_si256();
+                for (int k = 0; k < 15; k++) {
+                        __m256 ge = _mm256_cmp_ps(x,
+                                _mm256_set1_ps(t->threshold[k]), _CMP_GE_OQ);
+                        sum = _mm256_sub_epi32(sum, _mm256_castps_si256(ge));
+                }
+                _mm256_storeu_si256((__m256i *) &index[i], sum);
+        }
+        chroma_index_row_sse2(t, &avg[i], n - i, &index[i]);
+}
+#endif
+
+/**************************chroma_index_row********************************
+ * 
+ * Parameters:
+ *      const float *avg: n block chroma averages
+ *      unsigned n: number of averages
+ *      uint32_t *index: n indices to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arrays of n elements
+ * 
+ * Notes: dispatches to the best kernel for the cpu
+ * 
+ * *******************************************************************/
+void chroma_index_row(const float *avg, unsigned n, uint32_t *index)
+{
+        const chroma_table *t = chroma_table_get();
+#if SIMD_X86
+        switch (simd_detect()) {
+        case SIMD_AVX2:
+                chroma_index_row_avx2(t, avg, n, index);
+                return;
+        case SIMD_SSE2:
+                chroma_index_row_sse2(t, avg, n, index);
+                return;
+        default:
+                break;
+        }
+#endif
+        chroma_index_row_scalar(t, avg, n, index);
+}
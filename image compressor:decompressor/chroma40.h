@@ -0,0 +1,121 @@
+/***********************************************************************
+ * 
+ *                      chroma40.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the table-driven 4-bit chroma
+ *              quantizer that stands in for the arith40 library calls
+ * 
+ ***********************************************************************/
+#ifndef CHROMA40_INCLUDED
+#define CHROMA40_INCLUDED
+
+#include <stdint.h>
+
+/*value[i] is the chroma of index i; an average x has the index equal to
+ the number of thresholds t with x >= t. The sum_ and q15_ fields are
+ the same table for the fixed-point codec, where a chroma is an integer
+ in units of 2^-15 and a block average is kept as the sum of four*/
+typedef struct chroma_table {
+        float threshold[15];
+        float value[16];
+        int32_t sum_threshold[15];
+        int32_t q15_value[16];
+} chroma_table;
+
+/**************************chroma_table_get********************************
+ * 
+ * Parameters: 
+ *      None
+ * 
+ * Return: 
+ *      the quantization table
+ * 
+ * Expects: None
+ * 
+ * Notes: the table is built once, on the first call, from the arith40
+ *      library itself so the indices always agree with it
+ * 
+ * *******************************************************************/
+extern const chroma_table *chroma_table_get(void);
+
+/**************************chroma_index********************************
+ * 
+ * Parameters:
+ *      const chroma_table *t: table from chroma_table_get
+ *      float avg: average chroma of a block
+ * 
+ * Return: 
+ *      the 4-bit index Arith40_index_of_chroma gives for avg
+ * 
+ * Expects: valid table
+ * 
+ * *******************************************************************/
+static inline unsigned chroma_index(const chroma_table *t, float avg)
+{
+        unsigned index = 0;
+        for (int k = 0; k < 15; k++) {
+                index += (avg >= t->threshold[k]);
+        }
+        return index;
+}
+
+/**************************chroma_index_sum********************************
+ * 
+ * Parameters:
+ *      const chroma_table *t: table from chroma_table_get
+ *      int32_t sum: sum of the four chroma values of a block, each in
+ *              units of 2^-15
+ * 
+ * Return: 
+ *      the 4-bit index Arith40_index_of_chroma gives for sum / 2^17
+ * 
+ * Expects: valid table, |sum| below 2^24
+ * 
+ * *******************************************************************/
+static inline unsigned chroma_index_sum(const chroma_table *t, int32_t sum)
+{
+        unsigned index = 0;
+        for (int k = 0; k < 15; k++) {
+                index += (sum >= t->sum_threshold[k]);
+        }
+        return index;
+}
+
+/**************************chroma_value********************************
+ * 
+ * Parameters:
+ *      const chroma_table *t: table from chroma_table_get
+ *      unsigned index: 4-bit chroma index
+ * 
+ * Return: 
+ *      the chroma Arith40_chroma_of_index gives for index
+ * 
+ * Expects: valid table
+ * 
+ * *******************************************************************/
+static inline float chroma_value(const chroma_table *t, unsigned index)
+{
+        return t->value[index & 15];
+}
+
+/**************************chroma_index_row********************************
+ * 
+ * Parameters:
+ *      const float *avg: n block chroma averages
+ *      unsigned n: number of averages
+ *      uint32_t *index: n indices to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arrays of n elements
+ * 
+ * Notes: quantizes a whole row at once, with AVX2 or SSE2 when the cpu
+ *      has them
+ * 
+ * *******************************************************************/
+extern void chroma_index_row(const float *avg, unsigned n, uint32_t *index);
+
+#endif
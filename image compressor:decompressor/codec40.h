@@ -0,0 +1,455 @@
+/***********************************************************************
+ *
+ *                      codec40.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the per-pixel and per-block arithmetic
+ *              of the codec. The functions are static inline so that the
+ *              staged UArray2 pipeline and the fused block row kernels
+ *              compute exactly the same values
+ *
+ ***********************************************************************/
+#ifndef CODEC40_INCLUDED
+#define CODEC40_INCLUDED
+
+#include <stdint.h>
+#include "pnm.h"
+#include "chroma40.h"
+#include "codeword.h"
+#include "rgb_to_video.h"
+#include "videocs_to_word.h"
+
+/**********************get_range******************************
+ *
+ * Parameters:
+ *      float value: value to check if is in the low to high range
+ *      float low: low limit of the allowed range
+ *      float high: high limit of the allowed range
+ *
+ * Return:
+ *      returns a value in the specified range
+ *
+ * Expects: valid value, low and high floats
+ *
+ * Notes: get_range determines if y, pb and pr are in the required
+ *      range
+ *
+ *******************************************************************/
+static inline float get_range(float value, float low, float high) {
+        if (value < low) {
+                return low;
+        } else if (value > high) {
+                return high;
+        }
+        return value;
+}
+
+/**************************bcd_range********************************
+ *
+ * Parameters:
+ *      float val: a float to be checked if in the range [-0.3, 0.3]
+ *
+ * Return:
+ *      a float in the specified range for b, c, d values
+ *
+ * Expects: valid float
+ *
+ * Notes: bcd_range checks if the float is in the specified range. If so,
+ *      the value is returned otherwise, -0.3 or 0.3 is returned depending
+ *      on which is close
+ *
+ * *******************************************************************/
+static inline float bcd_range(float val) {
+        if (val > 0.3) {
+                return 0.3;
+        } else if (val < -0.3) {
+                return -0.3;
+        }
+        return val;
+}
+
+/**************************a_range********************************
+ *
+ * Parameters:
+ *      float val: a float to be checked if in the range [0.0, 1.0]
+ *
+ * Return:
+ *      a float in the specified range for a values
+ *
+ * Expects: valid float
+ *
+ * Notes: a_range checks if the float is in the specified range. If so,
+ *      the value is returned otherwise, 0.0 or 1.0 is returned depending
+ *      on which is close
+ *
+ * *******************************************************************/
+static inline float a_range(float val) {
+        if (val > 1) {
+                return 1.0;
+        } else if (val < 0) {
+                return 0.0;
+        }
+        return val;
+}
+
+/**************************a_float_to_int********************************
+ *
+ * Parameters:
+ *      float val: a float to be converted to uint64_t
+ *
+ * Return:
+ *      a uint64_t value of float val
+ *
+ * Expects: valid float
+ *
+ * Notes: a_float_to_int converts a float value of a to uint64_t by
+ *       multiplying it with a floating-point literal 511.0.We chose
+ *      511 because it is the maximum value of a in bits for a width of  9
+ *
+ * *******************************************************************/
+static inline uint64_t a_float_to_int(float val) {
+        return (uint64_t)(val * 511.0);
+}
+
+/**************************a_int_to_float********************************
+ *
+ * Parameters:
+ *      uint64_t val: a uint64_t val to be converted to a float
+ *
+ * Return:
+ *      a uint64_t value of float val
+ *
+ * Expects: valid uint64_t
+ *
+ * Notes: a_float_to_int converts uint64_t to a float by
+ *       dividing it with a floating-point literal 511.0. We chose
+ *      511 because it is the maximum value of a in bits for a width of  9
+ *
+ * *******************************************************************/
+static inline float a_int_to_float(uint64_t val) {
+        return ((float) val) / ((float) 511.0);
+}
+
+/**************************bcd_float_to_int********************************
+ *
+ * Parameters:
+ *      float val: a float to be converted to int64_t
+ *
+ * Return:
+ *      a int64_t value of float val
+ *
+ * Expects: valid float
+ *
+ * Notes: bcd_float_to_int converts a float value of a to int64_t by
+ *       multiplying it with a floating-point literal 31.0. We chose
+ *      31 because it is the maximum value of b, c, d in bits for a width of 5.
+ *      Before conversion b, c, d values are put in the range [-0.3, 0.3]
+ *
+ * *******************************************************************/
+static inline int64_t bcd_float_to_int(float val) {
+        val = bcd_range(val);
+        return (int64_t)(val * 31.0);
+}
+
+/**************************bcd_int_to_float********************************
+ *
+ * Parameters:
+ *      int64_t val: a int64_t val to be converted to a float
+ *
+ * Return:
+ *      a uint64_t value of float val
+ *
+ * Expects: valid uint64_t
+ *
+ * Notes: bcd_int_to_float converts int64_t to a float by
+ *       dividing it with a floating-point literal 31.0. We chose
+ *      31 because it is the maximum value of b, c, d in bits for a width of 5.
+ *
+ * *******************************************************************/
+static inline float bcd_int_to_float(int64_t val) {
+        return ((float) val) / ((float)31.0);
+}
+
+/**************************rgb_to_cs********************************
+ *
+ * Parameters:
+ *      const struct Pnm_rgb *pixel: rgb pixel to be transformed
+ *      unsigned denominator: maximum value of an rgb component
+ *      color_space cs: component video pixel to be filled in
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid pixel and cs pointers and a nonzero denominator
+ *
+ * Notes: computes y, pb and pr in double precision, as the spec's
+ *      constants are doubles, and clamps them to their ranges
+ *
+ * *******************************************************************/
+static inline void rgb_to_cs(const struct Pnm_rgb *pixel,
+        unsigned denominator, color_space cs)
+{
+        unsigned int r = pixel->red;
+        unsigned int g = pixel->green;
+        unsigned int b = pixel->blue;
+        float y, pb, pr;
+
+        y = (0.299 * r + 0.587 * g + 0.114 * b) / denominator;
+        cs->y = get_range(y, 0, 1);
+        pb = (-0.168736 * r - 0.331264 * g + 0.5 * b) / denominator;
+        cs->pb = get_range(pb, -0.5, 0.5);
+        pr = (0.5 * r - 0.418688 * g - 0.081312 * b) / denominator;
+        cs->pr = get_range(pr, -0.5, 0.5);
+}
+
+/**************************raw_pixelbytes********************************
+ *
+ * Parameters:
+ *      unsigned denominator: maximum value of an rgb component
+ *
+ * Return:
+ *      bytes per pixel of a P6 raster: 3 when the denominator is below
+ *      256, 6 otherwise
+ *
+ * Expects: None
+ *
+ * *******************************************************************/
+static inline unsigned raw_pixelbytes(unsigned denominator)
+{
+        return (denominator < 256) ? 3 : 6;
+}
+
+/**************************raw_to_rgb********************************
+ *
+ * Parameters:
+ *      const unsigned char *p: one pixel of a P6 raster
+ *      unsigned denominator: maximum value of an rgb component
+ *      Pnm_rgb pixel: rgb pixel to be filled in
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid pointers
+ *
+ * Notes: samples are one byte when the denominator is below 256 and two
+ *      big-endian bytes otherwise
+ *
+ * *******************************************************************/
+static inline void raw_to_rgb(const unsigned char *p, unsigned denominator,
+        Pnm_rgb pixel)
+{
+        if (denominator < 256) {
+                pixel->red = p[0];
+                pixel->green = p[1];
+                pixel->blue = p[2];
+        } else {
+                pixel->red = ((unsigned) p[0] << 8) | p[1];
+                pixel->green = ((unsigned) p[2] << 8) | p[3];
+                pixel->blue = ((unsigned) p[4] << 8) | p[5];
+        }
+}
+
+/**************************block_luma********************************
+ *
+ * Parameters:
+ *      float y1: luma of the top left pixel of a 2 by 2 block
+ *      float y2: luma of the top right pixel
+ *      float y3: luma of the bottom left pixel
+ *      float y4: luma of the bottom right pixel
+ *      bitword bit: uncoded word whose a, b, c and d are filled in
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid pointer
+ *
+ * Notes: computes and quantizes the cosine coefficients a, b, c and d
+ *
+ * *******************************************************************/
+static inline void block_luma(float y1, float y2, float y3, float y4,
+        bitword bit)
+{
+        float f_a, f_b, f_c, f_d;
+
+        f_a = (y4 + y3 + y2 + y1)/4.0;
+        f_b = (y4 + y3 - y2 - y1)/4.0;
+        f_c = (y4 - y3 + y2 - y1)/4.0;
+        f_d = (y4 - y3 - y2 + y1)/4.0;
+
+        bit->a = a_float_to_int(f_a);
+        bit->b = bcd_float_to_int(f_b);
+        bit->c = bcd_float_to_int(f_c);
+        bit->d = bcd_float_to_int(f_d);
+}
+
+/**************************block_chroma********************************
+ *
+ * Parameters:
+ *      float c1, c2, c3, c4: one chroma component of the four pixels of
+ *              a 2 by 2 block
+ *
+ * Return:
+ *      the average of the four values
+ *
+ * Expects: None
+ *
+ * *******************************************************************/
+static inline float block_chroma(float c1, float c2, float c3, float c4)
+{
+        return (c1 + c2 + c3+ c4) / 4;
+}
+
+/**************************block_to_bitword********************************
+ *
+ * Parameters:
+ *      const struct color_space *cs1: top left pixel of a 2 by 2 block
+ *      const struct color_space *cs2: top right pixel
+ *      const struct color_space *cs3: bottom left pixel
+ *      const struct color_space *cs4: bottom right pixel
+ *      bitword bit: uncoded word to be filled in
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid pointers
+ *
+ * Notes: computes the cosine coefficients a, b, c, d and the quantized
+ *      chroma averages avpb and avpr of one 2 by 2 block
+ *
+ * *******************************************************************/
+static inline void block_to_bitword(const struct color_space *cs1,
+        const struct color_space *cs2, const struct color_space *cs3,
+        const struct color_space *cs4, bitword bit)
+{
+        float a_pb = block_chroma(cs1->pb, cs2->pb, cs3->pb, cs4->pb);
+        float a_pr = block_chroma(cs1->pr, cs2->pr, cs3->pr, cs4->pr);
+
+        const chroma_table *t = chroma_table_get();
+
+        bit->av_pb = (uint64_t) chroma_index(t, a_pb);
+        bit->av_pr = (uint64_t) chroma_index(t, a_pr);
+        block_luma(cs1->y, cs2->y, cs3->y, cs4->y, bit);
+}
+
+/**************************pack_bitword********************************
+ *
+ * Parameters:
+ *      const struct bitword *bit: uncoded word a, b, c, d, avpb and avpr
+ *
+ * Return:
+ *      the 32-bit code word
+ *
+ * Expects: valid pointer, fields that fit their widths (checked only
+ *      when CODEWORD_CHECK is set)
+ *
+ * Notes: the layout comes from CODEWORD_FIELDS, so the shifts and masks
+ *      are constants and no call is made per field
+ *
+ * *******************************************************************/
+static inline uint32_t pack_bitword(const struct bitword *bit)
+{
+        uint32_t word = 0;
+        CODEWORD_FIELDS(CODEWORD_PUT)
+        return word;
+}
+
+/**************************unpack_bitword********************************
+ *
+ * Parameters:
+ *      uint32_t word: a 32-bit code word
+ *      bitword bit: uncoded word to be filled in
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid pointer
+ *
+ * Notes: extracts a, b, c, d, avpb and avpr from the code word
+ *
+ * *******************************************************************/
+static inline void unpack_bitword(uint32_t word, bitword bit)
+{
+        CODEWORD_FIELDS(CODEWORD_GET)
+}
+
+/**************************bitword_to_block********************************
+ *
+ * Parameters:
+ *      const struct bitword *bt: uncoded word a, b, c, d, avpb and avpr
+ *      color_space vcs1: top left pixel of a 2 by 2 block
+ *      color_space vcs2: top right pixel
+ *      color_space vcs3: bottom left pixel
+ *      color_space vcs4: bottom right pixel
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid pointers
+ *
+ * Notes: computes y, pb and pr of the four pixels of a 2 by 2 block
+ *      with the inverse cosine transform
+ *
+ * *******************************************************************/
+static inline void bitword_to_block(const struct bitword *bt,
+        color_space vcs1, color_space vcs2, color_space vcs3,
+        color_space vcs4)
+{
+        const chroma_table *t = chroma_table_get();
+        float a, b, c, d, pb, pr;
+        a = a_int_to_float(bt->a);
+        b = bcd_int_to_float(bt->b);
+        c = bcd_int_to_float(bt->c);
+        d = bcd_int_to_float(bt->d);
+
+        pb = chroma_value(t, bt->av_pb);
+        pr = chroma_value(t, bt->av_pr);
+
+        vcs1->pb = pb;
+        vcs1->pr = pr;
+        vcs2->pb = pb;
+        vcs2->pr = pr;
+        vcs3->pb = pb;
+        vcs3->pr = pr;
+        vcs4->pb = pb;
+        vcs4->pr = pr;
+
+        vcs1->y = a_range(a - b - c + d);
+        vcs2->y = a_range(a - b + c - d);
+        vcs3->y = a_range(a + b - c - d);
+        vcs4->y = a_range(a + b + c + d);
+}
+
+/**************************cs_to_rgb********************************
+ *
+ * Parameters:
+ *      const struct color_space *cs_pix: component video pixel
+ *      unsigned denominator: maximum value of an rgb component
+ *      Pnm_rgb rgb_pix: rgb pixel to be filled in
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid pointers
+ *
+ * Notes: computes r, g and b, clamps them to [0, 1] and scales them by
+ *      the denominator
+ *
+ * *******************************************************************/
+static inline void cs_to_rgb(const struct color_space *cs_pix,
+        unsigned denominator, Pnm_rgb rgb_pix)
+{
+        float r, g, b;
+        r = 1.0 * cs_pix->y + 0.0 * cs_pix->pb + 1.402 * cs_pix->pr;
+        g = 1.0 * cs_pix->y - 0.344136 * cs_pix->pb - 0.714136 * cs_pix->pr;
+        b = 1.0 * cs_pix->y + 1.772 * cs_pix->pb + 0.0 * cs_pix->pr;
+
+        r = get_range(r, 0.0, 1.0);
+        rgb_pix->red = (unsigned) (r * denominator);
+        g = get_range(g, 0.0, 1.0);
+        rgb_pix->green = (unsigned) (g * denominator);
+        b = get_range(b, 0.0, 1.0);
+        rgb_pix->blue = (unsigned) (b * denominator);
+}
+
+#endif
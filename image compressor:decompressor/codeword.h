@@ -0,0 +1,165 @@
+/***********************************************************************
+ *
+ *                      codeword.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file declares the layout of a 32-bit code word in
+ *              one place and packs and unpacks it with shifts and masks
+ *              that the compiler folds into constants. The layout is
+ *              checked when the file is compiled; the range of every
+ *              field is checked only when CODEWORD_CHECK is nonzero,
+ *              as in a debug build (make DEBUG=1)
+ *
+ ***********************************************************************/
+#ifndef CODEWORD_INCLUDED
+#define CODEWORD_INCLUDED
+
+#include <stdint.h>
+#include "assert.h"
+#include "bitpackrow.h"
+
+#ifndef CODEWORD_CHECK
+#define CODEWORD_CHECK 0
+#endif
+
+/*
+ * The fields of format 2, "COMP40 Compressed image format 2", as
+ * FIELD(member of struct bitword, width, lsb, u for unsigned or s for
+ * signed). A new format changes this list and the header line together
+ */
+#define CODEWORD_FIELDS(FIELD)          \
+        FIELD(a,     9, 23, u)          \
+        FIELD(b,     5, 18, s)          \
+        FIELD(c,     5, 13, s)          \
+        FIELD(d,     5,  8, s)          \
+        FIELD(av_pb, 4,  4, u)          \
+        FIELD(av_pr, 4,  0, u)
+
+/*the position of each field in CODEWORD_FIELDS, as CODEWORD_a and so on*/
+#define CODEWORD_INDEX(name, width, lsb, sign) CODEWORD_##name,
+enum { CODEWORD_FIELDS(CODEWORD_INDEX) CODEWORD_NFIELDS };
+
+/*the layout for bitpackrow_pack and bitpackrow_unpack, which take one
+ array per field in this order*/
+#define CODEWORD_SIGNED_u false
+#define CODEWORD_SIGNED_s true
+#define CODEWORD_BITFIELD(name, width, lsb, sign) \
+        { width, lsb, CODEWORD_SIGNED_##sign },
+static const bitfield codeword_layout[CODEWORD_NFIELDS] = {
+        CODEWORD_FIELDS(CODEWORD_BITFIELD)
+};
+
+/*the bits of a field, computed in 64 bits so a field past bit 31 shows*/
+#define CODEWORD_MASK(name, width, lsb, sign) \
+        + ((((uint64_t) 1 << (width)) - 1) << (lsb))
+#define CODEWORD_UNION(name, width, lsb, sign) \
+        | ((((uint64_t) 1 << (width)) - 1) << (lsb))
+
+/*the fields lie inside 32 bits, and no two share a bit: their masks add
+ up to the same value they or to*/
+typedef char codeword_fits_32_bits[
+        ((0 CODEWORD_FIELDS(CODEWORD_MASK)) <= 0xffffffffu) ? 1 : -1];
+typedef char codeword_fields_disjoint[
+        ((0 CODEWORD_FIELDS(CODEWORD_MASK)) ==
+         (0 CODEWORD_FIELDS(CODEWORD_UNION))) ? 1 : -1];
+
+/**************************codeword_putu********************************
+ *
+ * Parameters:
+ *      uint64_t value: unsigned field value
+ *      unsigned width: width of the field in bits
+ *      unsigned lsb: position of the least significant bit of the field
+ *
+ * Return:
+ *      value moved into place, to be or-ed into a code word
+ *
+ * Expects: value fits in width bits, checked if CODEWORD_CHECK
+ *
+ * Notes: a value that does not fit is cut to width bits, so it never
+ *      reaches the other fields
+ *
+ *******************************************************************/
+static inline uint32_t codeword_putu(uint64_t value, unsigned width,
+        unsigned lsb)
+{
+#if CODEWORD_CHECK
+        assert(value < ((uint64_t) 1 << width));
+#endif
+        return ((uint32_t) value & (((uint32_t) 1 << width) - 1)) << lsb;
+}
+
+/**************************codeword_puts********************************
+ *
+ * Parameters:
+ *      int64_t value: signed field value
+ *      unsigned width: width of the field in bits
+ *      unsigned lsb: position of the least significant bit of the field
+ *
+ * Return:
+ *      the two's complement of value moved into place
+ *
+ * Expects: value fits in width bits, checked if CODEWORD_CHECK
+ *
+ *******************************************************************/
+static inline uint32_t codeword_puts(int64_t value, unsigned width,
+        unsigned lsb)
+{
+#if CODEWORD_CHECK
+        assert(value >= -((int64_t) 1 << (width - 1)) &&
+               value < ((int64_t) 1 << (width - 1)));
+#endif
+        return ((uint32_t) value & (((uint32_t) 1 << width) - 1)) << lsb;
+}
+
+/**************************codeword_getu********************************
+ *
+ * Parameters:
+ *      uint32_t word: a code word
+ *      unsigned width: width of the field in bits
+ *      unsigned lsb: position of the least significant bit of the field
+ *
+ * Return:
+ *      the unsigned field
+ *
+ * Expects: None
+ *
+ *******************************************************************/
+static inline uint64_t codeword_getu(uint32_t word, unsigned width,
+        unsigned lsb)
+{
+        return (word >> lsb) & (((uint32_t) 1 << width) - 1);
+}
+
+/**************************codeword_gets********************************
+ *
+ * Parameters:
+ *      uint32_t word: a code word
+ *      unsigned width: width of the field in bits
+ *      unsigned lsb: position of the least significant bit of the field
+ *
+ * Return:
+ *      the signed field
+ *
+ * Expects: None
+ *
+ * Notes: the field is sign extended by bitpackrow_signext
+ *
+ *******************************************************************/
+static inline int64_t codeword_gets(uint32_t word, unsigned width,
+        unsigned lsb)
+{
+        return bitpackrow_signext((uint32_t) codeword_getu(word, width, lsb),
+                width);
+}
+
+/*
+ * Used as CODEWORD_FIELDS(CODEWORD_PUT) and CODEWORD_FIELDS(CODEWORD_GET),
+ * with a uint32_t word and a pointer bit to a struct bitword in scope
+ */
+#define CODEWORD_PUT(name, width, lsb, sign) \
+        word |= codeword_put##sign(bit->name, width, lsb);
+#define CODEWORD_GET(name, width, lsb, sign) \
+        bit->name = codeword_get##sign(word, width, lsb);
+
+#endif
@@ -0,0 +1,515 @@
+/***********************************************************************
+ * 
+ *                      colorconv.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements row-at-a-time conversion between
+ *              P6 rasters and planar component video, with SIMD versions
+ *              picked at run time.
+ * 
+ *              The kernels repeat the arithmetic of codec40.h operation
+ *              for operation: the color matrix is applied in double
+ *              precision in the same order, results are rounded to float,
+ *              and clamping uses min/max with the limit as the first
+ *              operand so an in-range value passes through unchanged just
+ *              as it does in get_range. The output is therefore bit-exact
+ *              with the scalar code.
+ * 
+ ***********************************************************************/
+#include "colorconv.h"
+#include "codec40.h"
+#include "simd.h"
+
+/*rows of the forward color matrix*/
+#define Y_R 0.299
+#define Y_G 0.587
+#define Y_B 0.114
+#define PB_R -0.168736
+#define PB_G 0.331264
+#define PB_B 0.5
+#define PR_R 0.5
+#define PR_G 0.418688
+#define PR_B 0.081312
+
+/*rows of the inverse color matrix. The 0.0 * pb term of r and the 
+ 0.0 * pr term of b in cs_to_rgb can only change the sign of a zero
+ result, which the conversion to an integer discards, so the kernels
+ leave them out*/
+#define R_PR 1.402
+#define G_PB 0.344136
+#define G_PR 0.714136
+#define B_PB 1.772
+
+/**************************rawrow_to_vcs_scalar********************************
+ * 
+ * Parameters: see rawrow_to_vcs
+ * 
+ * Notes: portable version, one pixel at a time
+ * 
+ * *******************************************************************/
+static void rawrow_to_vcs_scalar(const unsigned char *raw, unsigned n,
+        unsigned denominator, float *y, float *pb, float *pr)
+{
+        unsigned step = raw_pixelbytes(denominator);
+        for (unsigned i = 0; i < n; i++, raw += step) {
+                struct Pnm_rgb pix;
+                struct color_space cs;
+                raw_to_rgb(raw, denominator, &pix);
+                rgb_to_cs(&pix, denominator, &cs);
+                y[i] = cs.y;
+                pb[i] = cs.pb;
+                pr[i] = cs.pr;
+        }
+}
+
+/**************************vcsrow_to_rgb_scalar********************************
+ * 
+ * Parameters: see vcsrow_to_rgb
+ * 
+ * Notes: portable version, one pixel at a time
+ * 
+ * *******************************************************************/
+static void vcsrow_to_rgb_scalar(const float *y, const float *pb,
+        const float *pr, unsigned n, unsigned char *rgb)
+{
+        for (unsigned i = 0; i < n; i++) {
+                struct color_space cs = { y[i], pb[i], pr[i] };
+                struct Pnm_rgb pix;
+                cs_to_rgb(&cs, 255, &pix);
+                rgb[3 * i] = (unsigned char) pix.red;
+                rgb[3 * i + 1] = (unsigned char) pix.green;
+                rgb[3 * i + 2] = (unsigned char) pix.blue;
+        }
+}
+
+#if SIMD_X86
+/**************************clamp_ps********************************
+ * 
+ * Parameters:
+ *      __m128 v: four values to be clamped
+ *      __m128 lo: lower limits
+ *      __m128 hi: upper limits
+ * 
+ * Return: 
+ *      v clamped to [lo, hi] exactly as get_range does
+ * 
+ * *******************************************************************/
+static inline __m128 clamp_ps(__m128 v, __m128 lo, __m128 hi)
+{
+        return _mm_min_ps(hi, _mm_max_ps(lo, v));
+}
+
+/**************************rawrow_to_vcs_sse2********************************
+ * 
+ * Parameters: see rawrow_to_vcs
+ * 
+ * Notes: four pixels per iteration, two per double precision register
+ * 
+ * *******************************************************************/
+static void rawrow_to_vcs_sse2(const unsigned char *raw, unsigned n,
+        unsigned denominator, float *y, float *pb, float *pr)
+{
+        unsigned step = raw_pixelbytes(denominator);
+        const __m128d den = _mm_set1_pd((double) denominator);
+        const __m128 zero = _mm_set1_ps(0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 lo = _mm_set1_ps(-0.5f);
+        const __m128 hi = _mm_set1_ps(0.5f);
+        unsigned i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                __m128 fy[2], fpb[2], fpr[2];
+                for (int h = 0; h < 2; h++) {
+                        struct Pnm_rgb p[2];
+                        raw_to_rgb(&raw[(i + 2 * h) * step], denominator,
+                                &p[0]);
+                        raw_to_rgb(&raw[(i + 2 * h + 1) * step], denominator,
+                                &p[1]);
+                        __m128d r = _mm_set_pd(p[1].red, p[0].red);
+                        __m128d g = _mm_set_pd(p[1].green, p[0].green);
+                        __m128d b = _mm_set_pd(p[1].blue, p[0].blue);
+
+                        __m128d vy = _mm_add_pd(_mm_add_pd(
+                                _mm_mul_pd(_mm_set1_pd(Y_R), r),
+                                _mm_mul_pd(_mm_set1_pd(Y_G), g)),
+                                _mm_mul_pd(_mm_set1_pd(Y_B), b));
+                        __m128d vpb = _mm_add_pd(_mm_sub_pd(
+                                _mm_mul_pd(_mm_set1_pd(PB_R), r),
+                                _mm_mul_pd(_mm_set1_pd(PB_G), g)),
+                                _mm_mul_pd(_mm_set1_pd(PB_B), b));
+                        __m128d vpr = _mm_sub_pd(_mm_sub_pd(
+                                _mm_mul_pd(_mm_set1_pd(PR_R), r),
+                                _mm_mul_pd(_mm_set1_pd(PR_G), g)),
+                                _mm_mul_pd(_mm_set1_pd(PR_B), b));
+
+                        fy[h] = _mm_cvtpd_ps(_mm_div_pd(vy, den));
+                        fpb[h] = _mm_cvtpd_ps(_mm_div_pd(vpb, den));
+                        fpr[h] = _mm_cvtpd_ps(_mm_div_pd(vpr, den));
+                }
+                _mm_storeu_ps(&y[i], clamp_ps(_mm_movelh_ps(fy[0], fy[1]),
+                        zero, one));
+                _mm_storeu_ps(&pb[i], clamp_ps(_mm_movelh_ps(fpb[0], fpb[1]),
+                        lo, hi));
+                _mm_storeu_ps(&pr[i], clamp_ps(_mm_movelh_ps(fpr[0], fpr[1]),
+                        lo, hi));
+        }
+        rawrow_to_vcs_scalar(&raw[i * step], n - i, denominator, &y[i], 
+                &pb[i], &pr[i]);
+}
+
+/**************************to_float_avx2********************************
+ * 
+ * Parameters:
+ *      __m256d lo: results for pixels 0 to 3
+ *      __m256d hi: results for pixels 4 to 7
+ * 
+ * Return: 
+ *      the eight results rounded to float
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static inline __m256 to_float_avx2(__m256d lo, __m256d hi)
+{
+        return _mm256_insertf128_ps(
+                _mm256_castps128_ps256(_mm256_cvtpd_ps(lo)),
+                _mm256_cvtpd_ps(hi), 1);
+}
+
+/**************************rgb_to_vcs_avx2********************************
+ * 
+ * Parameters:
+ *      __m256i r, g, b: components of eight pixels
+ *      __m256d den: the denominator in every lane
+ *      float *y, *pb, *pr: eight values each to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static inline void rgb_to_vcs_avx2(__m256i r, __m256i g, __m256i b,
+        __m256d den, float *y, float *pb, float *pr)
+{
+        const __m256 zero = _mm256_set1_ps(0.0f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 lo = _mm256_set1_ps(-0.5f);
+        const __m256 hi = _mm256_set1_ps(0.5f);
+        __m256d vy[2], vpb[2], vpr[2];
+
+        for (int h = 0; h < 2; h++) {
+                __m128i r4 = h ? _mm256_extracti128_si256(r, 1) :
+                                 _mm256_castsi256_si128(r);
+                __m128i g4 = h ? _mm256_extracti128_si256(g, 1) :
+                                 _mm256_castsi256_si128(g);
+                __m128i b4 = h ? _mm256_extracti128_si256(b, 1) :
+                                 _mm256_castsi256_si128(b);
+                __m256d rd = _mm256_cvtepi32_pd(r4);
+                __m256d gd = _mm256_cvtepi32_pd(g4);
+                __m256d bd = _mm256_cvtepi32_pd(b4);
+
+                vy[h] = _mm256_div_pd(_mm256_add_pd(_mm256_add_pd(
+                        _mm256_mul_pd(_mm256_set1_pd(Y_R), rd),
+                        _mm256_mul_pd(_mm256_set1_pd(Y_G), gd)),
+                        _mm256_mul_pd(_mm256_set1_pd(Y_B), bd)), den);
+                vpb[h] = _mm256_div_pd(_mm256_add_pd(_mm256_sub_pd(
+                        _mm256_mul_pd(_mm256_set1_pd(PB_R), rd),
+                        _mm256_mul_pd(_mm256_set1_pd(PB_G), gd)),
+                        _mm256_mul_pd(_mm256_set1_pd(PB_B), bd)), den);
+                vpr[h] = _mm256_div_pd(_mm256_sub_pd(_mm256_sub_pd(
+                        _mm256_mul_pd(_mm256_set1_pd(PR_R), rd),
+                        _mm256_mul_pd(_mm256_set1_pd(PR_G), gd)),
+                        _mm256_mul_pd(_mm256_set1_pd(PR_B), bd)), den);
+        }
+
+        __m256 fy = to_float_avx2(vy[0], vy[1]);
+        __m256 fpb = to_float_avx2(vpb[0], vpb[1]);
+        __m256 fpr = to_float_avx2(vpr[0], vpr[1]);
+        _mm256_storeu_ps(y, _mm256_min_ps(one, _mm256_max_ps(zero, fy)));
+        _mm256_storeu_ps(pb, _mm256_min_ps(hi, _mm256_max_ps(lo, fpb)));
+        _mm256_storeu_ps(pr, _mm256_min_ps(hi, _mm256_max_ps(lo, fpr)));
+}
+
+/**************************rawrow_to_vcs_avx2********************************
+ * 
+ * Parameters: see rawrow_to_vcs
+ * 
+ * Notes: eight pixels of one-byte samples per iteration. The 24 bytes
+ *      are loaded as 16 + 8, so nothing past the row is touched, and
+ *      byte shuffles pull out the r, g and b samples, which are widened
+ *      to 32 bits. Two-byte samples go to the SSE2 kernel
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static void rawrow_to_vcs_avx2(const unsigned char *raw, unsigned n,
+        unsigned denominator, float *y, float *pb, float *pr)
+{
+        if (denominator > 255) {
+                rawrow_to_vcs_sse2(raw, n, denominator, y, pb, pr);
+                return;
+        }
+
+        const __m128i r_lo = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i r_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5,
+                -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i g_lo = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i g_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6,
+                -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i b_lo = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i b_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7,
+                -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m256d den = _mm256_set1_pd((double) denominator);
+        unsigned i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+                const unsigned char *p = &raw[3 * i];
+                __m128i lo = _mm_loadu_si128((const __m128i *) p);
+                __m128i hi = _mm_loadl_epi64((const __m128i *) (p + 16));
+                __m128i r8 = _mm_or_si128(_mm_shuffle_epi8(lo, r_lo),
+                        _mm_shuffle_epi8(hi, r_hi));
+                __m128i g8 = _mm_or_si128(_mm_shuffle_epi8(lo, g_lo),
+                        _mm_shuffle_epi8(hi, g_hi));
+                __m128i b8 = _mm_or_si128(_mm_shuffle_epi8(lo, b_lo),
+                        _mm_shuffle_epi8(hi, b_hi));
+
+                rgb_to_vcs_avx2(_mm256_cvtepu8_epi32(r8), 
+                        _mm256_cvtepu8_epi32(g8), _mm256_cvtepu8_epi32(b8),
+                        den, &y[i], &pb[i], &pr[i]);
+        }
+        rawrow_to_vcs_sse2(&raw[3 * i], n - i, denominator, &y[i], &pb[i],
+                &pr[i]);
+}
+
+/**************************vcs_to_rgb_sse2********************************
+ * 
+ * Parameters:
+ *      const float *y, *pb, *pr: two pixels of planar component video
+ *      __m128 *r, *g, *b: set to r, g and b scaled to [0, 255] in the low
+ *              two lanes
+ * 
+ * Return: 
+ *      None
+ * 
+ * *******************************************************************/
+static inline void vcs_to_rgb_sse2(const float *y, const float *pb,
+        const float *pr, __m128 *r, __m128 *g, __m128 *b)
+{
+        const __m128 zero = _mm_set1_ps(0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        __m128d vy = _mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64((const __m128i *) y)));
+        __m128d vpb = _mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64((const __m128i *) pb)));
+        __m128d vpr = _mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64((const __m128i *) pr)));
+
+        __m128 fr = _mm_cvtpd_ps(_mm_add_pd(vy,
+                _mm_mul_pd(_mm_set1_pd(R_PR), vpr)));
+        __m128 fg = _mm_cvtpd_ps(_mm_sub_pd(_mm_sub_pd(vy,
+                _mm_mul_pd(_mm_set1_pd(G_PB), vpb)),
+                _mm_mul_pd(_mm_set1_pd(G_PR), vpr)));
+        __m128 fb = _mm_cvtpd_ps(_mm_add_pd(vy,
+                _mm_mul_pd(_mm_set1_pd(B_PB), vpb)));
+
+        *r = _mm_mul_ps(clamp_ps(fr, zero, one), scale);
+        *g = _mm_mul_ps(clamp_ps(fg, zero, one), scale);
+        *b = _mm_mul_ps(clamp_ps(fb, zero, one), scale);
+}
+
+/**************************vcsrow_to_rgb_sse2********************************
+ * 
+ * Parameters: see vcsrow_to_rgb
+ * 
+ * Notes: four pixels per iteration, two per double precision register.
+ *      SSE2 has no byte shuffle, so the four finished pixels are 
+ *      interleaved with scalar stores
+ * 
+ * *******************************************************************/
+static void vcsrow_to_rgb_sse2(const float *y, const float *pb,
+        const float *pr, unsigned n, unsigned char *rgb)
+{
+        unsigned i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                __m128 r[2], g[2], b[2];
+                vcs_to_rgb_sse2(&y[i], &pb[i], &pr[i], &r[0], &g[0], &b[0]);
+                vcs_to_rgb_sse2(&y[i + 2], &pb[i + 2], &pr[i + 2], &r[1], 
+                        &g[1], &b[1]);
+
+                /*truncate toward zero, as the cast in cs_to_rgb does*/
+                int ir[4], ig[4], ib[4];
+                _mm_storeu_si128((__m128i *) ir,
+                        _mm_cvttps_epi32(_mm_movelh_ps(r[0], r[1])));
+                _mm_storeu_si128((__m128i *) ig,
+                        _mm_cvttps_epi32(_mm_movelh_ps(g[0], g[1])));
+                _mm_storeu_si128((__m128i *) ib,
+                        _mm_cvttps_epi32(_mm_movelh_ps(b[0], b[1])));
+
+                unsigned char *out = &rgb[3 * i];
+                for (int k = 0; k < 4; k++) {
+                        out[3 * k] = (unsigned char) ir[k];
+                        out[3 * k + 1] = (unsigned char) ig[k];
+                        out[3 * k + 2] = (unsigned char) ib[k];
+                }
+        }
+        vcsrow_to_rgb_scalar(&y[i], &pb[i], &pr[i], n - i, &rgb[3 * i]);
+}
+
+/**************************vcs_to_rgb_avx2********************************
+ * 
+ * Parameters:
+ *      __m128 y, pb, pr: four pixels of planar component video
+ * 
+ * Return: 
+ *      r, g, b scaled to [0, 255] and truncated, for the four pixels
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static inline void vcs_to_rgb_avx2(__m128 y, __m128 pb, __m128 pr,
+        __m128i *r, __m128i *g, __m128i *b)
+{
+        const __m128 zero = _mm_set1_ps(0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        __m256d vy = _mm256_cvtps_pd(y);
+        __m256d vpb = _mm256_cvtps_pd(pb);
+        __m256d vpr = _mm256_cvtps_pd(pr);
+
+        __m128 fr = _mm256_cvtpd_ps(_mm256_add_pd(vy,
+                _mm256_mul_pd(_mm256_set1_pd(R_PR), vpr)));
+        __m128 fg = _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_sub_pd(vy,
+                _mm256_mul_pd(_mm256_set1_pd(G_PB), vpb)),
+                _mm256_mul_pd(_mm256_set1_pd(G_PR), vpr)));
+        __m128 fb = _mm256_cvtpd_ps(_mm256_add_pd(vy,
+                _mm256_mul_pd(_mm256_set1_pd(B_PB), vpb)));
+
+        *r = _mm_cvttps_epi32(_mm_mul_ps(clamp_ps(fr, zero, one), scale));
+        *g = _mm_cvttps_epi32(_mm_mul_ps(clamp_ps(fg, zero, one), scale));
+        *b = _mm_cvttps_epi32(_mm_mul_ps(clamp_ps(fb, zero, one), scale));
+}
+
+/**************************vcsrow_to_rgb_avx2********************************
+ * 
+ * Parameters: see vcsrow_to_rgb
+ * 
+ * Notes: eight pixels per iteration. The integer results are narrowed
+ *      with saturating packs and interleaved into 24 output bytes with
+ *      two byte shuffles
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static void vcsrow_to_rgb_avx2(const float *y, const float *pb,
+        const float *pr, unsigned n, unsigned char *rgb)
+{
+        /*bytes 0-15 of the output, from rg = r0..r7 g0..g7 and from
+         b = b0..b7; -1 leaves a zero for the other shuffle to fill*/
+        const __m128i rg_lo = _mm_setr_epi8(0, 8, -1, 1, 9, -1, 2, 10,
+                -1, 3, 11, -1, 4, 12, -1, 5);
+        const __m128i b_lo = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1,
+                2, -1, -1, 3, -1, -1, 4, -1);
+        /*bytes 16-23 of the output*/
+        const __m128i rg_hi = _mm_setr_epi8(13, -1, 6, 14, -1, 7, 15, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i b_hi = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7,
+                -1, -1, -1, -1, -1, -1, -1, -1);
+        unsigned i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+                __m128i r[2], g[2], b[2];
+                for (int h = 0; h < 2; h++) {
+                        unsigned k = i + 4 * h;
+                        vcs_to_rgb_avx2(_mm_loadu_ps(&y[k]),
+                                _mm_loadu_ps(&pb[k]), _mm_loadu_ps(&pr[k]),
+                                &r[h], &g[h], &b[h]);
+                }
+                __m128i rg = _mm_packus_epi16(_mm_packs_epi32(r[0], r[1]),
+                        _mm_packs_epi32(g[0], g[1]));
+                __m128i bb = _mm_packus_epi16(_mm_packs_epi32(b[0], b[1]),
+                        _mm_setzero_si128());
+
+                unsigned char *out = &rgb[3 * i];
+                _mm_storeu_si128((__m128i *) out, _mm_or_si128(
+                        _mm_shuffle_epi8(rg, rg_lo),
+                        _mm_shuffle_epi8(bb, b_lo)));
+                _mm_storel_epi64((__m128i *) (out + 16), _mm_or_si128(
+                        _mm_shuffle_epi8(rg, rg_hi),
+                        _mm_shuffle_epi8(bb, b_hi)));
+        }
+        vcsrow_to_rgb_sse2(&y[i], &pb[i], &pr[i], n - i, &rgb[3 * i]);
+}
+#endif
+
+/**************************rawrow_to_vcs********************************
+ * 
+ * Parameters:
+ *      const unsigned char *raw: row of n pixels of P6 samples
+ *      unsigned n: number of pixels in the row
+ *      unsigned denominator: maximum value of an rgb component
+ *      float *y: n luma values to be filled in
+ *      float *pb: n blue chroma values to be filled in
+ *      float *pr: n red chroma values to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arrays of n elements, denominator from 1 to 65535
+ * 
+ * Notes: dispatches to the best kernel for the cpu
+ * 
+ * *******************************************************************/
+void rawrow_to_vcs(const unsigned char *raw, unsigned n,
+        unsigned denominator, float *y, float *pb, float *pr)
+{
+#if SIMD_X86
+        switch (simd_detect()) {
+        case SIMD_AVX2:
+                rawrow_to_vcs_avx2(raw, n, denominator, y, pb, pr);
+                return;
+        case SIMD_SSE2:
+                rawrow_to_vcs_sse2(raw, n, denominator, y, pb, pr);
+                return;
+        default:
+                break;
+        }
+#endif
+        rawrow_to_vcs_scalar(raw, n, denominator, y, pb, pr);
+}
+
+/**************************vcsrow_to_rgb********************************
+ * 
+ * Parameters:
+ *      const float *y: n luma values
+ *      const float *pb: n blue chroma values
+ *      const float *pr: n red chroma values
+ *      unsigned n: number of pixels in the row
+ *      unsigned char *rgb: 3 * n bytes to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arrays
+ * 
+ * Notes: dispatches to the best kernel for the cpu
+ * 
+ * *******************************************************************/
+void vcsrow_to_rgb(const float *y, const float *pb, const float *pr,
+        unsigned n, unsigned char *rgb)
+{
+#if SIMD_X86
+        switch (simd_detect()) {
+        case SIMD_AVX2:
+                vcsrow_to_rgb_avx2(y, pb, pr, n, rgb);
+                return;
+        case SIMD_SSE2:
+                vcsrow_to_rgb_sse2(y, pb, pr, n, rgb);
+                return;
+        default:
+                break;
+        }
+#endif
+        vcsrow_to_rgb_scalar(y, pb, pr, n, rgb);
+}
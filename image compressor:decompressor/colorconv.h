@@ -0,0 +1,62 @@
+/***********************************************************************
+ * 
+ *                      colorconv.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains function declarations for colorconv.c
+ * 
+ ***********************************************************************/
+#ifndef COLORCONV_INCLUDED
+#define COLORCONV_INCLUDED
+
+/**************************rawrow_to_vcs********************************
+ * 
+ * Parameters:
+ *      const unsigned char *raw: row of n pixels of P6 samples, one byte
+ *              each when the denominator is below 256 and two big-endian
+ *              bytes otherwise
+ *      unsigned n: number of pixels in the row
+ *      unsigned denominator: maximum value of an rgb component
+ *      float *y: n luma values to be filled in
+ *      float *pb: n blue chroma values to be filled in
+ *      float *pr: n red chroma values to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arrays of n elements, denominator from 1 to 65535
+ * 
+ * Notes: converts a whole row straight from the raster to planar
+ *      component video, without building Pnm_rgb pixels. Uses AVX2 or
+ *      SSE2 when the cpu has them; the values are identical to the ones
+ *      computed by rgb_to_cs in codec40.h
+ * 
+ * *******************************************************************/
+extern void rawrow_to_vcs(const unsigned char *raw, unsigned n,
+        unsigned denominator, float *y, float *pb, float *pr);
+
+/**************************vcsrow_to_rgb********************************
+ * 
+ * Parameters:
+ *      const float *y: n luma values
+ *      const float *pb: n blue chroma values
+ *      const float *pr: n red chroma values
+ *      unsigned n: number of pixels in the row
+ *      unsigned char *rgb: 3 * n bytes to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid arrays
+ * 
+ * Notes: converts a whole row of planar component video to interleaved
+ *      r, g, b bytes for a denominator of 255, ready to be written as a
+ *      P6 scanline. Uses AVX2 or SSE2 when the cpu has them; the bytes
+ *      are identical to the ones computed by cs_to_rgb in codec40.h
+ * 
+ * *******************************************************************/
+extern void vcsrow_to_rgb(const float *y, const float *pb, const float *pr,
+        unsigned n, unsigned char *rgb);
+
+#endif
@@ -18,8 +18,519 @@
 #include "uarray2.h"
 #include "bitpack.h"
 #include "imageprocessor.h"
+#include "blockrow.h"
+#include "fixedrow.h"
+#include "threadpool.h"
+#include "arena.h"
+#include "spscring.h"
+#include <pthread.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
+#include <sys/stat.h>
+/*kernels that turn one row of blocks into code words and back*/
+typedef void compress_rowfun(const unsigned char *top,
+        const unsigned char *bottom, unsigned nblocks, unsigned denominator,
+        uint32_t *words);
+typedef void decompress_rowfun(const uint32_t *words, unsigned nblocks,
+        unsigned char *top, unsigned char *bottom);
+
+/*block rows compressed by one task of the thread pool*/
+#define BAND_ROWS 16
+/*bands read ahead per thread before the pool is started*/
+#define BANDS_PER_THREAD 4
+/*memory of a streaming run under a budget that does not grow with its
+ batches: stdio buffers and the reader, plus the stack and malloc state
+ of every thread it runs on*/
+#define FIXED_BYTES (512 << 10)
+#define THREAD_BYTES (128 << 10)
+
+/*buffers and arrays of the images converted on this thread; each image
+ resets it, so after the first image its memory is reused instead of
+ allocated again*/
+static __thread arena scratch = NULL;
+
+/*the arena of this thread, emptied for a new image*/
+static arena image_arena(void)
+{
+        if (scratch == NULL) {
+                scratch = arena_new();
+        } else {
+                arena_reset(scratch);
+        }
+        return scratch;
+}
+
+/*one batch of block rows handed to the thread pool*/
+typedef struct compress_batch {
+        compress_rowfun *compress_row;
+        const unsigned char **rows;     /*top and bottom of each block row*/
+        unsigned nrows;                 /*block rows in the batch*/
+        unsigned width;                 /*blocks per row*/
+        unsigned denominator;
+        unsigned band_rows;             /*block rows per task of the pool*/
+        uint32_t *words;                /*width + 1 words per block row*/
+} compress_batch;
+
+/*how a streaming run splits its image: block rows per task of the
+ thread pool and block rows held by one batch or chunk*/
+typedef struct band_plan {
+        unsigned band_rows;
+        unsigned batch_rows;
+} band_plan;
+
+/**************************plan_bands********************************
+ * 
+ * Parameters: 
+ *      unsigned height: block rows in the image
+ *      unsigned batch_rows: block rows of a batch without a budget
+ *      unsigned nbatches: batches held at once
+ *      size_t rowbytes: bytes one block row of a batch holds
+ *      size_t budget: bytes the batches may hold, or 0 for no budget
+ * 
+ * Return: 
+ *      band and batch sizes for the run
+ * 
+ * Expects: nbatches and rowbytes greater than 0
+ * 
+ * Notes: under a budget a batch shrinks until nbatches of them fit in
+ *      it, but never below one block row, and bands shrink with it so
+ *      every thread still gets one. The sizes only change how the work
+ *      is split, never the output
+ * 
+ * *******************************************************************/
+static band_plan plan_bands(unsigned height, unsigned batch_rows,
+        unsigned nbatches, size_t rowbytes, size_t budget)
+{
+        band_plan plan = { BAND_ROWS, batch_rows };
+        if (budget > 0) {
+                size_t fit = budget / ((size_t) nbatches * rowbytes);
+                if (fit < plan.batch_rows) {
+                        plan.batch_rows = (fit > 0) ? (unsigned) fit : 1;
+                }
+                unsigned nthreads = threadpool_size(threadpool_shared());
+                unsigned share = (plan.batch_rows + nthreads - 1) / nthreads;
+                if (share < plan.band_rows) {
+                        plan.band_rows = share;
+                }
+        }
+        if (plan.batch_rows > height) {
+                plan.batch_rows = (height > 0) ? height : 1;
+        }
+        return plan;
+}
+
+/*the bytes of max_memory left for the batches of a run once FIXED_BYTES,
+ THREAD_BYTES for each thread and buffer bytes are set aside, or 0 when
+ there is no budget. A budget too small for them leaves 1, the smallest
+ batches*/
+static size_t batch_budget(size_t max_memory, size_t buffer, 
+        bool pipelined)
+{
+        if (max_memory == 0) {
+                return 0;
+        }
+        unsigned nthreads = threadpool_size(threadpool_shared()) + 
+                (pipelined ? 2 : 0);
+        size_t fixed = FIXED_BYTES + (size_t) nthreads * THREAD_BYTES + 
+                buffer;
+        return (max_memory > fixed + 1) ? max_memory - fixed : 1;
+}
+
+/**************************compress40_set_threads*****************************
+ * 
+ * Parameters: 
+ *      unsigned n: number of threads, or 0 for one per online cpu
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: called before any image is compressed or decompressed
+ * 
+ * Notes: sets the size of the shared thread pool, which the streaming
+ *      pipelines and the map_parallel of the staged pipeline run on. 1,
+ *      the default, keeps everything on the calling thread
+ * 
+ * *******************************************************************/
+void compress40_set_threads(unsigned n) {
+        threadpool_shared_size(n);
+}
+
+/*chunks of block rows in flight between the stages of a pipelined run*/
+#define PIPE_CHUNKS 4
+
+/*one stage of a pipelined run, applied to a chunk; cl is the closure of
+ the run*/
+typedef void pipe_stagefun(void *chunk, void *cl);
+
+/*a pipelined run: the reader thread fills chunks, the calling thread
+ transforms them and the writer thread writes them, in order. Chunks go
+ round through the rings empty, full and done*/
+typedef struct pipeline {
+        pipe_stagefun *read;
+        pipe_stagefun *transform;
+        pipe_stagefun *write;
+        void *cl;
+        unsigned nchunks;               /*chunks in the whole image*/
+        spsc_ring empty;                /*writer to reader*/
+        spsc_ring full;                 /*reader to transform*/
+        spsc_ring done;                 /*transform to writer*/
+} pipeline;
+
+/*the reader thread: fills every chunk of the image, then sends NULL*/
+static void *pipe_reader(void *cl)
+{
+        pipeline *pipe = cl;
+        for (unsigned k = 0; k < pipe->nchunks; k++) {
+                void *chunk = spscring_pop(pipe->empty);
+                pipe->read(chunk, pipe->cl);
+                spscring_push(pipe->full, chunk);
+        }
+        spscring_push(pipe->full, NULL);
+        return NULL;
+}
+
+/*the writer thread: writes chunks until NULL and hands them back*/
+static void *pipe_writer(void *cl)
+{
+        pipeline *pipe = cl;
+        void *chunk;
+        while ((chunk = spscring_pop(pipe->done)) != NULL) {
+                pipe->write(chunk, pipe->cl);
+                spscring_push(pipe->empty, chunk);
+        }
+        return NULL;
+}
+
+/**************************pipe_run********************************
+ * 
+ * Parameters: 
+ *      pipeline *pipe: stages, closure and number of chunks of the run
+ *      void **chunks: PIPE_CHUNKS chunk buffers to cycle
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pipe and chunks
+ * 
+ * Notes: starts the reader and writer threads and transforms on the
+ *      calling thread, so reading, computing and writing of different
+ *      chunks overlap and the run takes about as long as its slowest
+ *      stage. Every ring has room for all chunks and the final NULL, so
+ *      only an empty ring ever makes a stage wait. CRE is raised when a
+ *      thread cannot be started
+ * 
+ * *******************************************************************/
+static void pipe_run(pipeline *pipe, void **chunks)
+{
+        pipe->empty = spscring_new(PIPE_CHUNKS + 1);
+        pipe->full = spscring_new(PIPE_CHUNKS + 1);
+        pipe->done = spscring_new(PIPE_CHUNKS + 1);
+        for (unsigned k = 0; k < PIPE_CHUNKS; k++) {
+                spscring_push(pipe->empty, chunks[k]);
+        }
+
+        pthread_t reader, writer;
+        int failed = pthread_create(&reader, NULL, pipe_reader, pipe);
+        assert(failed == 0);
+        failed = pthread_create(&writer, NULL, pipe_writer, pipe);
+        assert(failed == 0);
+
+        void *chunk;
+        while ((chunk = spscring_pop(pipe->full)) != NULL) {
+                pipe->transform(chunk, pipe->cl);
+                spscring_push(pipe->done, chunk);
+        }
+        spscring_push(pipe->done, NULL);
+
+        pthread_join(reader, NULL);
+        pthread_join(writer, NULL);
+        spscring_free(&pipe->empty);
+        spscring_free(&pipe->full);
+        spscring_free(&pipe->done);
+}
+
+/*compresses the block rows of one band of a batch*/
+static void compress_band(unsigned band, void *cl)
+{
+        compress_batch *batch = cl;
+        unsigned first = band * batch->band_rows;
+        unsigned last = first + batch->band_rows;
+        if (last > batch->nrows) {
+                last = batch->nrows;
+        }
+        for (unsigned r = first; r < last; r++) {
+                batch->compress_row(batch->rows[2 * r], batch->rows[2 * r + 1],
+                        batch->width, batch->denominator, 
+                        batch->words + (size_t) r * (batch->width + 1));
+        }
+}
+
+/*bytes one block row of a compression batch holds: its code words, its
+ two row pointers and its two rows of input*/
+static size_t compress_rowbytes(ppm_reader reader)
+{
+        return (size_t) (reader->width / 2 + 1) * sizeof(uint32_t) + 
+                2 * sizeof(const unsigned char *) + 2 * reader->rowbytes;
+}
+
+/**************************compress_parallel********************************
+ * 
+ * Parameters: 
+ *      ppm_reader reader: reader positioned at the first row
+ *      word_writer writer: writer the code words go to
+ *      compress_rowfun *compress_row: kernel for one row of blocks
+ *      arena mem: arena the batch buffers come from
+ *      size_t budget: bytes the batch may hold, or 0 for no budget
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid reader and writer
+ * 
+ * Notes: reads a batch of block rows, has the thread pool compress it in
+ *      bands of BAND_ROWS block rows, then writes the batch in order.
+ *      Bands share nothing but the read-only rows, so the words are the
+ *      same as on one thread. Rows that are views into a mapped file are
+ *      used in place; any other rows are copied into the batch, since
+ *      the reader reuses its buffers. Under a budget the batch and its
+ *      bands are sized by plan_bands
+ * 
+ * *******************************************************************/
+static void compress_parallel(ppm_reader reader, word_writer writer,
+        compress_rowfun *compress_row, arena mem, size_t budget)
+{
+        unsigned width = reader->width / 2;
+        unsigned height = reader->height / 2;
+        thread_pool pool = threadpool_shared();
+        bool copy = !ppmreader_views(reader);
+        size_t rowbytes = reader->rowbytes;
+        band_plan plan = plan_bands(height, threadpool_size(pool) * 
+                BANDS_PER_THREAD * BAND_ROWS, 1, compress_rowbytes(reader),
+                budget);
+        unsigned batch_rows = plan.batch_rows;
+
+        compress_batch batch;
+        batch.compress_row = compress_row;
+        batch.width = width;
+        batch.denominator = reader->denominator;
+        batch.band_rows = plan.band_rows;
+        batch.rows = arena_alloc(mem, 2 * batch_rows * sizeof(*batch.rows));
+        batch.words = arena_alloc(mem, (size_t) batch_rows * (width + 1) * 
+                sizeof(*batch.words));
+        unsigned char *raw = copy ? arena_alloc(mem, 2 * batch_rows * rowbytes)
+                                  : NULL;
+
+        for (unsigned done = 0; done < height; done += batch.nrows) {
+                batch.nrows = height - done;
+                if (batch.nrows > batch_rows) {
+                        batch.nrows = batch_rows;
+                }
+                for (unsigned k = 0; k < 2 * batch.nrows; k++) {
+                        const unsigned char *row = ppmreader_row(reader);
+                        if (copy) {
+                                memcpy(raw + k * rowbytes, row, rowbytes);
+                                row = raw + k * rowbytes;
+                        }
+                        batch.rows[k] = row;
+                }
+
+                unsigned nbands = (batch.nrows + batch.band_rows - 1) / 
+                        batch.band_rows;
+                threadpool_run(pool, nbands, compress_band, &batch);
+
+                for (unsigned r = 0; r < batch.nrows; r++) {
+                        wordwriter_row(writer, 
+                                batch.words + (size_t) r * (width + 1), width);
+                }
+        }
+}
+
+/*a chunk of a pipelined compression*/
+typedef struct compress_chunk {
+        compress_batch batch;
+        unsigned char *raw;             /*copies of rows that are not views*/
+} compress_chunk;
+
+/*the closure of a pipelined compression; each stage touches only its
+ own fields*/
+typedef struct compress_pipe {
+        ppm_reader reader;              /*the reader's*/
+        unsigned rows_left;             /*the reader's: block rows unread*/
+        unsigned chunk_rows;
+        word_writer writer;             /*the writer's*/
+} compress_pipe;
+
+/*reads the next block rows of the image into a chunk. Rows that are
+ views into the mapped file are touched once per page, so the page
+ faults are taken here instead of by the transform*/
+static void compress_read(void *chunk, void *cl)
+{
+        compress_chunk *c = chunk;
+        compress_pipe *p = cl;
+        size_t rowbytes = p->reader->rowbytes;
+        bool copy = !ppmreader_views(p->reader);
+
+        c->batch.nrows = (p->rows_left < p->chunk_rows) ? p->rows_left
+                                                        : p->chunk_rows;
+        p->rows_left -= c->batch.nrows;
+        for (unsigned k = 0; k < 2 * c->batch.nrows; k++) {
+                const unsigned char *row = ppmreader_row(p->reader);
+                if (copy) {
+                        memcpy(c->raw + k * rowbytes, row, rowbytes);
+                        row = c->raw + k * rowbytes;
+                } else {
+                        for (size_t b = 0; b < rowbytes; b += 4096) {
+                                (void) *(volatile const unsigned char *) 
+                                        &row[b];
+                        }
+                }
+                c->batch.rows[k] = row;
+        }
+}
+
+/*compresses a chunk in bands on the shared thread pool*/
+static void compress_transform(void *chunk, void *cl)
+{
+        compress_chunk *c = chunk;
+        (void) cl;
+        unsigned nbands = (c->batch.nrows + c->batch.band_rows - 1) / 
+                c->batch.band_rows;
+        threadpool_run(threadpool_shared(), nbands, compress_band, &c->batch);
+}
+
+/*writes the code words of a chunk*/
+static void compress_write(void *chunk, void *cl)
+{
+        compress_chunk *c = chunk;
+        compress_pipe *p = cl;
+        for (unsigned r = 0; r < c->batch.nrows; r++) {
+                wordwriter_row(p->writer, c->batch.words + 
+                        (size_t) r * (c->batch.width + 1), c->batch.width);
+        }
+}
+
+/**************************compress_pipelined********************************
+ * 
+ * Parameters: 
+ *      ppm_reader reader: reader positioned at the first row
+ *      word_writer writer: writer the code words go to
+ *      compress_rowfun *compress_row: kernel for one row of blocks
+ *      arena mem: arena the chunks come from
+ *      size_t budget: bytes the chunks may hold, or 0 for no budget
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid reader and writer
+ * 
+ * Notes: runs the image through pipe_run in chunks of block rows: one
+ *      thread reads rows, the calling thread compresses them with the
+ *      thread pool, and one thread writes the words. A chunk is one band
+ *      per thread, or what fits PIPE_CHUNKS of them in the budget. The
+ *      words are the same as compress_stream's
+ * 
+ * *******************************************************************/
+static void compress_pipelined(ppm_reader reader, word_writer writer,
+        compress_rowfun *compress_row, arena mem, size_t budget)
+{
+        unsigned width = reader->width / 2;
+        unsigned height = reader->height / 2;
+        band_plan plan = plan_bands(height, 
+                threadpool_size(threadpool_shared()) * BAND_ROWS, 
+                PIPE_CHUNKS, compress_rowbytes(reader), budget);
+        unsigned chunk_rows = plan.batch_rows;
+        bool copy = !ppmreader_views(reader);
+        compress_pipe p = { reader, height, chunk_rows, writer };
+        pipeline pipe = { compress_read, compress_transform, compress_write,
+                &p, (height + chunk_rows - 1) / chunk_rows, NULL, NULL, 
+                NULL };
+        void *chunks[PIPE_CHUNKS];
+
+        for (unsigned k = 0; k < PIPE_CHUNKS; k++) {
+                compress_chunk *c = arena_alloc(mem, sizeof(*c));
+                c->batch.compress_row = compress_row;
+                c->batch.width = width;
+                c->batch.denominator = reader->denominator;
+                c->batch.band_rows = plan.band_rows;
+                c->batch.nrows = 0;
+                c->batch.rows = arena_alloc(mem, 2 * chunk_rows * 
+                        sizeof(*c->batch.rows));
+                c->batch.words = arena_alloc(mem, (size_t) chunk_rows * 
+                        (width + 1) * sizeof(*c->batch.words));
+                c->raw = copy ? arena_alloc(mem, 2 * chunk_rows * 
+                        reader->rowbytes) : NULL;
+                chunks[k] = c;
+        }
+        pipe_run(&pipe, chunks);
+}
+
+/**************************compress_stream********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file or stdin
+ *      FILE *output: stream the compressed image is written to
+ *      compress_rowfun *compress_row: kernel for one row of blocks
+ *      bool pipelined: read, compress and write on separate threads
+ *      size_t max_memory: bytes the run may hold, or 0 for no budget
+ *      bool reserve: whether room for the image may be reserved in output
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid input and output file pointers
+ * 
+ * Notes: streams a PPM image to a compressed binary image two pixel rows
+ *      at a time, taking the rows as views of the raster from the
+ *      ppm_reader. Every block row is transformed and packed by 
+ *      compress_row and handed to a word_writer, so memory use is bounded
+ *      by a few rows and the output buffer whatever the image size. A
+ *      trailing odd row or column is never used. With more than one
+ *      thread the block rows are compressed by compress_parallel, and
+ *      when pipelined by compress_pipelined; the output is byte for byte
+ *      the same. Under a memory budget the input is read instead of
+ *      mapped, so the image does not become resident, and what is left
+ *      after the output buffer and batch_budget's allowance for the
+ *      threads sizes the batches
+ * 
+ * *******************************************************************/
+static void compress_stream(FILE *input, FILE *output,
+        compress_rowfun *compress_row, bool pipelined, size_t max_memory,
+        bool reserve) {
+        arena mem = image_arena();
+        ppm_reader reader = ppmreader_new(input, mem, max_memory == 0);
+        /*blocks per row and block rows of the trimmed image*/
+        unsigned width = reader->width / 2;
+        unsigned height = reader->height / 2;
+        word_writer writer = wordwriter_new(output, width * 2, height * 2, 
+                reserve, mem);
+        size_t budget = batch_budget(max_memory, writer->cap, pipelined);
+
+        if (pipelined) {
+                compress_pipelined(reader, writer, compress_row, mem, budget);
+                wordwriter_free(&writer);
+                ppmreader_free(&reader);
+                return;
+        }
+        if (threadpool_size(threadpool_shared()) > 1) {
+                compress_parallel(reader, writer, compress_row, mem, budget);
+                wordwriter_free(&writer);
+                ppmreader_free(&reader);
+                return;
+        }
+
+        uint32_t *words = arena_alloc(mem, (width + 1) * sizeof(*words));
+        for (unsigned r = 0; r < height; r++) {
+                const unsigned char *top = ppmreader_row(reader);
+                const unsigned char *bottom = ppmreader_row(reader);
+                compress_row(top, bottom, width, reader->denominator, words);
+                wordwriter_row(writer, words, width);
+        }
+
+        wordwriter_free(&writer);
+        ppmreader_free(&reader);
+}
+
 /**************************compress40********************************
  * 
  * Parameters: 
@@ -30,40 +541,366 @@
  * 
  * Expects: valid input file pointer
  * 
- * Notes: compress40 calls the compression functions that transform a PPM
- *      image to a compressed binary image
+ * Notes: compress40 streams a PPM image to a compressed binary image,
+ *      one block row at a time, with blockrow_compress
  * 
  * *******************************************************************/
 void compress40 (FILE *input) {
+        compress_stream(input, stdout, blockrow_compress, false, 0, false);
+}
+
+/**************************compress40_fixed********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file or stdin
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid input file pointer
+ * 
+ * Notes: same as compress40 with the integer-only fixedrow_compress
+ * 
+ * *******************************************************************/
+void compress40_fixed(FILE *input) {
+        compress_stream(input, stdout, fixedrow_compress, false, 0, false);
+}
+
+/**************************compress_staged********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file or stdin
+ *      FILE *output: stream the compressed image is written to
+ *      A2Methods_T methods: methods for the UArray2s of every stage,
+ *              uarray2_methods_plain or uarray2_methods_blocked
+ *      bool reserve: whether room for the image may be reserved in output
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid input and output file pointers and methods
+ * 
+ * Notes: compress_staged calls the compression functions that transform
+ *      a PPM image to a compressed binary image one whole image at a time.
+ *      Its output is identical to compress_stream's
+ * 
+ * *******************************************************************/
+static void compress_staged(FILE *input, FILE *output, A2Methods_T methods,
+        bool reserve) {
 
-        /* default to UArray2 methods */
-        A2Methods_T methods = uarray2_methods_plain; 
         assert(methods != NULL);
 
-        /* default to best map */
-        A2Methods_mapfun *map = methods->map_default; 
+        /* the stages only write their own cells, so they may run on the
+         shared thread pool; otherwise default to best map */
+        A2Methods_mapfun *map = (methods->map_parallel != NULL) ? 
+                methods->map_parallel : methods->map_default;
         assert(map != NULL);
 
+        /*every stage after the first is allocated from the arena*/
+        arena mem = image_arena();
+
         /*ppm image from input file*/
         Pnm_ppm image = readppmimage(input, methods);
   
-        /*rgb pixels to video component color space*/
-        A2Methods_UArray2 video_cs = rgb_to_videocs(image, methods, map);
+        /*rgb pixels to y, pb and pr planes of component video*/
+        vcs_planes video_cs = rgb_to_videocs(image, methods, map, mem);
+
+        /*the rgb pixels are done with; free them before the next stage*/
+        Pnm_ppmfree(&image);
         
-        /*from component video color space to cosine coeff a,b,c,d & pb, pr*/
-        A2Methods_UArray2 bit_word = vcs_to_word(video_cs, methods, map);
+        /*from component video color space to planes of cosine coeff
+         a,b,c,d & pb, pr*/
+        word_planes bit_word = vcs_to_word(video_cs, methods, map, mem);
+
+        /*the planes are done with too, so the code words and the output
+         buffer are placed in their memory*/
+        arena_recycle(mem, methods, video_cs.y);
+        arena_recycle(mem, methods, video_cs.pb);
+        arena_recycle(mem, methods, video_cs.pr);
         
         /*32-bit word packing*/
-        A2Methods_UArray2 pack_word = word_to_codedword(bit_word, methods, map);
+        A2Methods_UArray2 pack_word = word_to_codedword(bit_word, methods, 
+                map, mem);
    
-        /*printing to stdout*/
-        print_compressedimg(pack_word, methods);
-        
-        Pnm_ppmfree(&image);
-        methods->free(&video_cs);
-        methods->free(&bit_word);
-        methods->free(&pack_word);
+        /*printing to output*/
+        print_compressedimg(output, pack_word, methods, reserve, mem);
+}
+
+/**************************compress40_staged********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file or stdin
+ *      A2Methods_T methods: methods for the UArray2s of every stage
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid input file pointer and methods
+ * 
+ * Notes: runs compress_staged to stdout
+ * 
+ * *******************************************************************/
+void compress40_staged(FILE *input, A2Methods_T methods) {
+        compress_staged(input, stdout, methods, false);
+}
+
+/*one batch of block rows of code words handed to the thread pool*/
+typedef struct decompress_batch {
+        decompress_rowfun *decompress_row;
+        uint32_t *words;                /*width + 1 words per block row*/
+        unsigned nrows;                 /*block rows in the batch*/
+        unsigned width;                 /*blocks per row*/
+        unsigned band_rows;             /*block rows per task of the pool*/
+        unsigned char *pixels;          /*two P6 scanlines per block row*/
+} decompress_batch;
+
+/*decodes the block rows of one band of a batch*/
+static void decompress_band(unsigned band, void *cl)
+{
+        decompress_batch *batch = cl;
+        size_t linebytes = (size_t) batch->width * 6;
+        unsigned first = band * batch->band_rows;
+        unsigned last = first + batch->band_rows;
+        if (last > batch->nrows) {
+                last = batch->nrows;
+        }
+        for (unsigned r = first; r < last; r++) {
+                unsigned char *top = batch->pixels + 2 * r * linebytes;
+                batch->decompress_row(
+                        batch->words + (size_t) r * (batch->width + 1),
+                        batch->width, top, top + linebytes);
+        }
+}
+
+/*bytes one block row of a decompression batch holds: its code words
+ and its two P6 scanlines*/
+static size_t decompress_rowbytes(unsigned width)
+{
+        return (size_t) (width + 1) * sizeof(uint32_t) + (size_t) width * 12;
+}
+
+/**************************decompress_parallel********************************
+ * 
+ * Parameters: 
+ *      word_reader reader: reader positioned at the first row of words
+ *      FILE *output: stream the P6 scanlines are printed to
+ *      decompress_rowfun *decompress_row: kernel for one row of blocks
+ *      arena mem: arena the batch buffers come from
+ *      size_t budget: bytes the batch may hold, or 0 for no budget
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid reader, and the PPM header already printed
+ * 
+ * Notes: reads a batch of rows of code words, has the thread pool decode
+ *      it in bands of BAND_ROWS block rows into disjoint scanlines of one
+ *      P6 buffer, then prints the batch in order. Every block decodes on
+ *      its own, so the pixels are the same as on one thread. Under a
+ *      budget the batch and its bands are sized by plan_bands
+ * 
+ * *******************************************************************/
+static void decompress_parallel(word_reader reader, FILE *output,
+        decompress_rowfun *decompress_row, arena mem, size_t budget)
+{
+        unsigned width = reader->width / 2;
+        unsigned height = reader->height / 2;
+        thread_pool pool = threadpool_shared();
+        band_plan plan = plan_bands(height, threadpool_size(pool) * 
+                BANDS_PER_THREAD * BAND_ROWS, 1, decompress_rowbytes(width),
+                budget);
+        unsigned batch_rows = plan.batch_rows;
+
+        decompress_batch batch;
+        batch.decompress_row = decompress_row;
+        batch.width = width;
+        batch.band_rows = plan.band_rows;
+        uint32_t *words = arena_alloc(mem, (size_t) batch_rows * (width + 1) * 
+                sizeof(*words));
+        batch.pixels = arena_alloc(mem, (size_t) batch_rows * width * 12);
+        batch.words = words;
+
+        for (unsigned done = 0; done < height; done += batch.nrows) {
+                batch.nrows = height - done;
+                if (batch.nrows > batch_rows) {
+                        batch.nrows = batch_rows;
+                }
+                for (unsigned r = 0; r < batch.nrows; r++) {
+                        wordreader_row(reader, 
+                                words + (size_t) r * (width + 1), width);
+                }
+
+                unsigned nbands = (batch.nrows + batch.band_rows - 1) / 
+                        batch.band_rows;
+                threadpool_run(pool, nbands, decompress_band, &batch);
+
+                for (unsigned r = 0; r < batch.nrows; r++) {
+                        print_ppmrow(output, 
+                                batch.pixels + (size_t) r * width * 12,
+                                width * 4);
+                }
+        }
 }
+
+/*the closure of a pipelined decompression; each stage touches only its
+ own fields*/
+typedef struct decompress_pipe {
+        word_reader reader;             /*the reader's*/
+        unsigned rows_left;             /*the reader's: block rows unread*/
+        unsigned chunk_rows;
+        FILE *output;                   /*the writer's*/
+} decompress_pipe;
+
+/*reads the next rows of code words of the image into a chunk*/
+static void decompress_read(void *chunk, void *cl)
+{
+        decompress_batch *c = chunk;
+        decompress_pipe *p = cl;
+
+        c->nrows = (p->rows_left < p->chunk_rows) ? p->rows_left 
+                                                  : p->chunk_rows;
+        p->rows_left -= c->nrows;
+        for (unsigned r = 0; r < c->nrows; r++) {
+                wordreader_row(p->reader, 
+                        c->words + (size_t) r * (c->width + 1), c->width);
+        }
+}
+
+/*decodes a chunk in bands on the shared thread pool*/
+static void decompress_transform(void *chunk, void *cl)
+{
+        decompress_batch *c = chunk;
+        (void) cl;
+        unsigned nbands = (c->nrows + c->band_rows - 1) / c->band_rows;
+        threadpool_run(threadpool_shared(), nbands, decompress_band, c);
+}
+
+/*prints the scanlines of a chunk*/
+static void decompress_write(void *chunk, void *cl)
+{
+        decompress_batch *c = chunk;
+        decompress_pipe *p = cl;
+        for (unsigned r = 0; r < c->nrows; r++) {
+                print_ppmrow(p->output, c->pixels + (size_t) r * c->width * 12,
+                        c->width * 4);
+        }
+}
+
+/**************************decompress_pipelined*****************************
+ * 
+ * Parameters: 
+ *      word_reader reader: reader positioned at the first row of words
+ *      FILE *output: stream the P6 scanlines are printed to
+ *      decompress_rowfun *decompress_row: kernel for one row of blocks
+ *      arena mem: arena the chunks come from
+ *      size_t budget: bytes the chunks may hold, or 0 for no budget
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid reader, and the PPM header already printed
+ * 
+ * Notes: runs the image through pipe_run in chunks of block rows: one
+ *      thread reads code words, the calling thread decodes them with the
+ *      thread pool, and one thread prints the scanlines. A chunk is one
+ *      band per thread, or what fits PIPE_CHUNKS of them in the budget.
+ *      The pixels are the same as decompress_stream's
+ * 
+ * *******************************************************************/
+static void decompress_pipelined(word_reader reader, FILE *output,
+        decompress_rowfun *decompress_row, arena mem, size_t budget)
+{
+        unsigned width = reader->width / 2;
+        unsigned height = reader->height / 2;
+        band_plan plan = plan_bands(height, 
+                threadpool_size(threadpool_shared()) * BAND_ROWS, 
+                PIPE_CHUNKS, decompress_rowbytes(width), budget);
+        unsigned chunk_rows = plan.batch_rows;
+        decompress_pipe p = { reader, height, chunk_rows, output };
+        pipeline pipe = { decompress_read, decompress_transform, 
+                decompress_write, &p, (height + chunk_rows - 1) / chunk_rows,
+                NULL, NULL, NULL };
+        void *chunks[PIPE_CHUNKS];
+
+        for (unsigned k = 0; k < PIPE_CHUNKS; k++) {
+                decompress_batch *c = arena_alloc(mem, sizeof(*c));
+                c->decompress_row = decompress_row;
+                c->width = width;
+                c->band_rows = plan.band_rows;
+                c->nrows = 0;
+                c->words = arena_alloc(mem, (size_t) chunk_rows * 
+                        (width + 1) * sizeof(*c->words));
+                c->pixels = arena_alloc(mem, (size_t) chunk_rows * width * 12);
+                chunks[k] = c;
+        }
+        pipe_run(&pipe, chunks);
+}
+
+/**************************decompress_stream********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file or stdin
+ *      FILE *output: stream the PPM image is written to
+ *      decompress_rowfun *decompress_row: kernel for one row of blocks
+ *      bool pipelined: read, decode and print on separate threads
+ *      size_t max_memory: bytes the run may hold, or 0 for no budget
+ *      bool reserve: whether room for the image may be reserved in output
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid input and output file pointers
+ * 
+ * Notes: streams a compressed binary image to a PPM image one row of 
+ *      code words at a time. Each row is decoded by decompress_row into
+ *      two finished P6 scanlines which are printed right away, so memory
+ *      use grows with the width only. The words come from a word_reader,
+ *      which raises file_err when the file is shorter than its header
+ *      says, before anything is printed when the input is a file. With
+ *      more than one thread the rows are decoded by decompress_parallel,
+ *      and when pipelined by decompress_pipelined. Under a memory budget
+ *      the input is read instead of mapped and what is left after
+ *      batch_budget's allowance for the threads sizes the batches
+ * 
+ * *******************************************************************/
+static void decompress_stream(FILE *input, FILE *output,
+        decompress_rowfun *decompress_row, bool pipelined, 
+        size_t max_memory, bool reserve) {
+        arena mem = image_arena();
+        word_reader reader = wordreader_new(input, max_memory == 0, mem);
+        /*blocks per row and block rows*/
+        unsigned width = reader->width / 2;
+        unsigned height = reader->height / 2;
+
+        size_t budget = batch_budget(max_memory, 0, pipelined);
+
+        print_ppmheader(output, width * 2, height * 2, reserve);
+        if (pipelined) {
+                decompress_pipelined(reader, output, decompress_row, mem,
+                        budget);
+                wordreader_free(&reader);
+                return;
+        }
+        if (threadpool_size(threadpool_shared()) > 1) {
+                decompress_parallel(reader, output, decompress_row, mem, 
+                        budget);
+                wordreader_free(&reader);
+                return;
+        }
+
+        uint32_t *words = arena_alloc(mem, (width + 1) * sizeof(*words));
+        unsigned char *top = arena_alloc(mem, (size_t) width * 6);
+        unsigned char *bottom = arena_alloc(mem, (size_t) width * 6);
+        for (unsigned r = 0; r < height; r++) {
+                wordreader_row(reader, words, width);
+                decompress_row(words, width, top, bottom);
+                print_ppmrow(output, top, width * 2);
+                print_ppmrow(output, bottom, width * 2);
+        }
+
+        wordreader_free(&reader);
+}
+
 /**************************decompress40********************************
  * 
  * Parameters: 
@@ -74,45 +911,182 @@ void compress40 (FILE *input) {
  * 
  * Expects: valid input file pointer
  * 
- * Notes: decompress40 calls the compression functions that transform a 
- *      compressed binary image to a PPM image.
+ * Notes: decompress40 streams a compressed binary image to a PPM image,
+ *      one row of code words at a time, with blockrow_decompress
  * 
  * *******************************************************************/
 void decompress40(FILE *input) {
+        decompress_stream(input, stdout, blockrow_decompress, false, 0, 
+                false);
+}
+
+/**************************decompress40_fixed********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file or stdin
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid input file pointer
+ * 
+ * Notes: same as decompress40 with the integer-only fixedrow_decompress
+ * 
+ * *******************************************************************/
+void decompress40_fixed(FILE *input) {
+        decompress_stream(input, stdout, fixedrow_decompress, false, 0,
+                false);
+}
+
+/**************************decompress_staged********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file or stdin
+ *      FILE *output: stream the PPM image is written to
+ *      A2Methods_T methods: methods for the UArray2s of every stage,
+ *              uarray2_methods_plain or uarray2_methods_blocked
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid input and output file pointers and methods
+ * 
+ * Notes: decompress_staged calls the decompression functions that 
+ *      transform a compressed binary image to a PPM image one whole image
+ *      at a time. Its output is identical to decompress_stream's
+ * 
+ * *******************************************************************/
+static void decompress_staged(FILE *input, FILE *output, 
+        A2Methods_T methods) {
 
-        A2Methods_T methods = uarray2_methods_plain; 
         assert(methods != NULL);
 
-        /* default to best map */
-        A2Methods_mapfun *map = methods->map_default; 
+        /* the stages only write their own cells, so they may run on the
+         shared thread pool; otherwise default to best map */
+        A2Methods_mapfun *map = (methods->map_parallel != NULL) ? 
+                methods->map_parallel : methods->map_default;
         assert(map != NULL);
         
+        /*every stage is allocated from the arena*/
+        arena mem = image_arena();
+        
         /*reading the compressed file into an array of 32-bit code words*/
-        A2Methods_UArray2 coded_arr = code_word(input, methods);
+        A2Methods_UArray2 coded_arr = code_word(input, methods, mem);
         
-        /*coded word to an uncoded word*/
-        A2Methods_UArray2 word_arr = codedword_to_word(coded_arr, methods, map);
+        /*coded word to planes of uncoded words*/
+        word_planes word_arr = codedword_to_word(coded_arr, methods, map, 
+                mem);
 
-        /*uncoded word to component video color space pixels*/
-        A2Methods_UArray2 vcs_arr = word_to_vcs(word_arr, methods, map);
+        /*uncoded word to component video color space planes*/
+        vcs_planes vcs_arr = word_to_vcs(word_arr, methods, map, mem);
 
         /*component video color space to RGB pixels*/
-        A2Methods_UArray2 rgb_pix = vidcs_to_rgb(vcs_arr, methods, map);
-        
-        /*initializing a Pnm_ppm image*/
-        Pnm_ppm finalpix = malloc(sizeof(*finalpix));
-        assert(finalpix != NULL);
-
-        finalpix->methods = methods;
-        finalpix->pixels = rgb_pix;
-        finalpix->denominator = 255;
-        finalpix->width = (unsigned) methods->width(rgb_pix);
-        finalpix->height = (unsigned) methods->height(rgb_pix);
+        A2Methods_UArray2 rgb_pix = vidcs_to_rgb(vcs_arr, methods, map, mem);
         
-        Pnm_ppmwrite(stdout, finalpix);
+        /*the Pnm_ppm only describes rgb_pix, so it lives on the stack*/
+        struct Pnm_ppm finalpix;
+        finalpix.methods = methods;
+        finalpix.pixels = rgb_pix;
+        finalpix.denominator = 255;
+        finalpix.width = (unsigned) methods->width(rgb_pix);
+        finalpix.height = (unsigned) methods->height(rgb_pix);
         
-        methods->free(&coded_arr);
-        methods->free(&word_arr);
-        methods->free(&vcs_arr);
-        Pnm_ppmfree(&finalpix);
-}
\ No newline at end of file
+        Pnm_ppmwrite(output, &finalpix);
+}
+
+/**************************decompress40_staged********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file or stdin
+ *      A2Methods_T methods: methods for the UArray2s of every stage
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid input file pointer and methods
+ * 
+ * Notes: runs decompress_staged to stdout
+ * 
+ * *******************************************************************/
+void decompress40_staged(FILE *input, A2Methods_T methods) {
+        decompress_staged(input, stdout, methods);
+}
+
+/**************************compress40_run********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file or stdin
+ *      FILE *output: stream the result is written to
+ *      compress40_mode mode: direction and pipeline to run
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid input and output file pointers
+ * 
+ * Notes: every other entry point is compress40_run with stdout; this
+ *      one lets several images be converted at once, each to its own
+ *      stream. mode.max_memory only bounds the streaming pipelines; the
+ *      staged one holds whole images whatever it is
+ * 
+ * *******************************************************************/
+void compress40_run(FILE *input, FILE *output, compress40_mode mode) {
+        assert(input != NULL && output != NULL);
+        if (mode.staged != NULL && mode.decompress) {
+                decompress_staged(input, output, mode.staged);
+        } else if (mode.staged != NULL) {
+                compress_staged(input, output, mode.staged, mode.reserve);
+        } else if (mode.decompress) {
+                decompress_stream(input, output, mode.fixed ? 
+                        fixedrow_decompress : blockrow_decompress, 
+                        mode.pipelined, mode.max_memory, mode.reserve);
+        } else {
+                compress_stream(input, output, mode.fixed ? 
+                        fixedrow_compress : blockrow_compress, 
+                        mode.pipelined, mode.max_memory, mode.reserve);
+        }
+}
+
+/**************************compress40_check********************************
+ * 
+ * Parameters: 
+ *      FILE *input: A file pointer to an input file
+ *      compress40_mode mode: direction and pipeline it will be run with
+ * 
+ * Return: 
+ *      true when converting input can no longer raise an exception
+ * 
+ * Expects: valid input file pointer
+ * 
+ * Notes: the check is the one the pipeline of mode starts with. Both
+ *      decompressing pipelines read the words through wordreader_new,
+ *      and the streaming compressor reads through ppmreader_new; each
+ *      checks the size of a regular file against its header, raising
+ *      file_err when it is too short and a CRE when the header is
+ *      invalid, and once that passes the file is read to its end without
+ *      another check failing. The staged compressor parses the image
+ *      with Pnm_ppmread, whose checks are its own, so it gives false and
+ *      is only checked as it is read. Nothing is mapped
+ * 
+ * *******************************************************************/
+bool compress40_check(FILE *input, compress40_mode mode) {
+        assert(input != NULL);
+        struct stat st;
+        if (fstat(fileno(input), &st) != 0 || !S_ISREG(st.st_mode)) {
+                return false;
+        }
+        if (mode.staged != NULL && !mode.decompress) {
+                return false;
+        }
+
+        arena mem = image_arena();
+        if (mode.decompress) {
+                word_reader reader = wordreader_new(input, false, mem);
+                wordreader_free(&reader);
+                return true;
+        }
+        ppm_reader reader = ppmreader_new(input, mem, false);
+        bool raw = !reader->plain;
+        ppmreader_free(&reader);
+        return raw;
+}
@@ -0,0 +1,64 @@
+/***********************************************************************
+ * 
+ *                      compress40.h
+ *      Assignment: Arith
+ *      Authors: CS40 instructors, Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the interface to the compressor. It
+ *              extends the course interface with the staged reference
+ *              pipeline
+ * 
+ ***********************************************************************/
+#ifndef COMPRESS40_INCLUDED
+#define COMPRESS40_INCLUDED
+#include <stdio.h>
+#include <stdbool.h>
+#include "a2methods.h"
+
+/*reads PPM, writes compressed image*/
+extern void compress40  (FILE *input);
+/*reads compressed image, writes PPM*/
+extern void decompress40(FILE *input);
+
+/*same as compress40 and decompress40, but materialize every stage of the
+ pipeline as a full-size UArray2 made by the given methods*/
+extern void compress40_staged(FILE *input, A2Methods_T methods);
+extern void decompress40_staged(FILE *input, A2Methods_T methods);
+
+/*same as compress40 and decompress40, but with integer arithmetic only;
+ the output is within the tolerance documented in fixedrow.h*/
+extern void compress40_fixed(FILE *input);
+extern void decompress40_fixed(FILE *input);
+
+/*number of threads the streaming pipelines may use; 1, the default, runs
+ them on the calling thread and 0 uses one thread per online cpu. The
+ output does not depend on it*/
+extern void compress40_set_threads(unsigned n);
+
+/*the direction and pipeline of one run of the codec*/
+typedef struct compress40_mode {
+        bool decompress;
+        bool fixed;             /*integer-only streaming kernels*/
+        bool pipelined;         /*streaming: read, transform and write on
+                                  their own threads*/
+        A2Methods_T staged;     /*methods of the staged pipeline, or NULL
+                                  for the streaming one*/
+        size_t max_memory;      /*streaming: bytes the run may hold, or 0
+                                  for no budget*/
+        bool reserve;           /*the output is a file opened for the run,
+                                  where room for the image is reserved*/
+} compress40_mode;
+
+/*runs the pipeline given by mode from input to output; the functions
+ above all run it to stdout*/
+extern void compress40_run(FILE *input, FILE *output, compress40_mode mode);
+
+/*true when compress40_run of input in mode can no longer raise: input is
+ a regular file with a valid header and a raster as long as the header
+ says, checked by the reader mode's pipeline uses. Raises file_err or a
+ CRE when it cannot be converted. P3 images, input other than a regular
+ file and images for the staged compressor are only checked as they are
+ read, so they give false. Leaves input anywhere*/
+extern bool compress40_check(FILE *input, compress40_mode mode);
+
+#endif
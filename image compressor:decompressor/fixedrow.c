@@ -0,0 +1,283 @@
+/***********************************************************************
+ * 
+ *                      fixedrow.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements the block row kernels in fixed
+ *              point, with no floating point on the per-pixel path.
+ * 
+ *              y, pb and pr are integers in units of 2^-15 (Q15), so y
+ *              runs from 0 to 32768 and pb, pr from -16384 to 16384. The
+ *              color matrices use coefficients scaled by 2^14 (Q14) and
+ *              rounded so each row of the forward matrix still sums to
+ *              exactly 1 or 0. A block is described by the sums of its
+ *              four pixels, which are exact; a, b, c and d are quantized
+ *              straight from those sums, and the chroma sums are looked
+ *              up in the integer thresholds of chroma40.c. Every result
+ *              is the same on any compiler and cpu.
+ * 
+ *              C99 leaves the right shift of a negative number to the
+ *              compiler, so every signed value is shifted by floor_shift,
+ *              which divides with unsigned arithmetic and rounds toward
+ *              minus infinity. It only assumes what <stdint.h> promises:
+ *              int32_t and int64_t are two's complement.
+ * 
+ ***********************************************************************/
+#include "fixedrow.h"
+#include "chroma40.h"
+#include "codec40.h"
+
+/*blocks handled per pass; the planar buffers of a pass fit in L1*/
+#define CHUNK 128
+
+#define Q15_ONE 32768
+#define Q15_HALF 16384
+#define Q14_ROUND 8192
+
+/*Q14 forward matrix; rows sum to 16384, 0 and 0*/
+#define Y_R 4899
+#define Y_G 9617
+#define Y_B 1868
+#define PB_R (-2765)
+#define PB_G (-5427)
+#define PB_B 8192
+#define PR_R 8192
+#define PR_G (-6860)
+#define PR_B (-1332)
+
+/*Q14 inverse matrix*/
+#define R_PR 22970
+#define G_PB 5638
+#define G_PR 11700
+#define B_PB 29032
+
+/*largest |b|, |c|, |d|: 0.3 * 31 truncated*/
+#define BCD_MAX 9
+
+static inline int32_t clamp_int(int64_t v, int32_t lo, int32_t hi)
+{
+        return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/**************************floor_shift********************************
+ * 
+ * Parameters:
+ *      int64_t v: value to be scaled down
+ *      unsigned bits: power of two to divide by, from 1 to 63
+ * 
+ * Return: 
+ *      v / 2^bits rounded toward minus infinity
+ * 
+ * Expects: None
+ * 
+ * Notes: v is biased by 2^63 into an unsigned number, shifted, and the
+ *      shifted bias taken off again. Both parts fit in an int64_t, so
+ *      the result is exact for every v. Adding half of 2^bits first
+ *      rounds to nearest
+ * 
+ * *******************************************************************/
+static inline int64_t floor_shift(int64_t v, unsigned bits)
+{
+        const uint64_t bias = (uint64_t) 1 << 63;
+        uint64_t biased = (uint64_t) v + bias;
+        return (int64_t) (biased >> bits) - (int64_t) (bias >> bits);
+}
+
+/**************************rawrow_to_q15********************************
+ * 
+ * Parameters:
+ *      const unsigned char *raw: row of n pixels of P6 samples
+ *      unsigned n: number of pixels
+ *      unsigned denominator: maximum value of an rgb component
+ *      uint32_t scale: 2^31 / denominator, rounded
+ *      int32_t *y, *pb, *pr: n Q15 values each to be filled in
+ * 
+ * Notes: a component v becomes (v * scale) >> 16, which is v / den in
+ *      Q15 to within one unit. A P6 sample may be larger than den, as in
+ *      the float path, so the products are 64-bit: only y, pb and pr are
+ *      clamped, the way rgb_to_cs clamps them. The products with the Q14
+ *      matrix are rounded to nearest by floor_shift
+ * 
+ * *******************************************************************/
+static void rawrow_to_q15(const unsigned char *raw, unsigned n,
+        unsigned denominator, uint32_t scale, int32_t *y, int32_t *pb,
+        int32_t *pr)
+{
+        unsigned step = raw_pixelbytes(denominator);
+        for (unsigned i = 0; i < n; i++, raw += step) {
+                struct Pnm_rgb pix;
+                raw_to_rgb(raw, denominator, &pix);
+                int64_t r = (int64_t) (((uint64_t) pix.red * scale) >> 16);
+                int64_t g = (int64_t) (((uint64_t) pix.green * scale) >> 16);
+                int64_t b = (int64_t) (((uint64_t) pix.blue * scale) >> 16);
+
+                y[i] = clamp_int(floor_shift(Y_R * r + Y_G * g + Y_B * b + 
+                        Q14_ROUND, 14), 0, Q15_ONE);
+                pb[i] = clamp_int(floor_shift(PB_R * r + PB_G * g + 
+                        PB_B * b + Q14_ROUND, 14), -Q15_HALF, Q15_HALF);
+                pr[i] = clamp_int(floor_shift(PR_R * r + PR_G * g + 
+                        PR_B * b + Q14_ROUND, 14), -Q15_HALF, Q15_HALF);
+        }
+}
+
+/**************************fixedrow_compress********************************
+ * 
+ * Parameters:
+ *      const unsigned char *top: first pixel row of the block row, as
+ *              P6 samples
+ *      const unsigned char *bottom: second pixel row of the block row
+ *      unsigned nblocks: number of 2 by 2 blocks in the block row
+ *      unsigned denominator: maximum value of an rgb component
+ *      uint32_t *words: array of nblocks code words to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: both rows hold at least 2 * nblocks pixels, denominator from
+ *      1 to 65535
+ * 
+ * Notes: a sum s of four Q15 lumas is 2^17 times their average, so
+ *      a = s * 511 / 2^17 and b = s * 31 / 2^17, truncated toward zero
+ *      like the float casts; limiting b, c and d to 9 is the same as
+ *      clamping them to 0.3 first
+ * 
+ * *******************************************************************/
+void fixedrow_compress(const unsigned char *top,
+        const unsigned char *bottom, unsigned nblocks, unsigned denominator,
+        uint32_t *words)
+{
+        int32_t y[2][2 * CHUNK], pb[2][2 * CHUNK], pr[2][2 * CHUNK];
+        const chroma_table *t = chroma_table_get();
+        uint32_t scale = (uint32_t) ((((uint64_t) 1 << 31) + denominator / 2)
+                / denominator);
+        unsigned step = raw_pixelbytes(denominator);
+        int32_t field[CODEWORD_NFIELDS][CHUNK];
+        const int32_t *fields[CODEWORD_NFIELDS];
+
+        for (int f = 0; f < CODEWORD_NFIELDS; f++)
+                fields[f] = field[f];
+
+        for (unsigned c0 = 0; c0 < nblocks; c0 += CHUNK) {
+                unsigned n = (nblocks - c0 < CHUNK) ? nblocks - c0 : CHUNK;
+
+                size_t offset = (size_t) 2 * c0 * step;
+
+                rawrow_to_q15(&top[offset], 2 * n, denominator, scale, y[0],
+                        pb[0], pr[0]);
+                rawrow_to_q15(&bottom[offset], 2 * n, denominator, scale, 
+                        y[1], pb[1], pr[1]);
+
+                for (unsigned k = 0; k < n; k++) {
+                        unsigned l = 2 * k, r = 2 * k + 1;
+                        int32_t y1 = y[0][l], y2 = y[0][r];
+                        int32_t y3 = y[1][l], y4 = y[1][r];
+                        int32_t sb = (y4 + y3) - (y2 + y1);
+                        int32_t sc = (y4 - y3) + (y2 - y1);
+                        int32_t sd = (y4 - y3) - (y2 - y1);
+
+                        field[CODEWORD_a][k] = floor_shift(
+                                (y1 + y2 + y3 + y4) * 511, 17);
+                        field[CODEWORD_b][k] = clamp_int(sb * 31 / 131072, 
+                                -BCD_MAX, BCD_MAX);
+                        field[CODEWORD_c][k] = clamp_int(sc * 31 / 131072, 
+                                -BCD_MAX, BCD_MAX);
+                        field[CODEWORD_d][k] = clamp_int(sd * 31 / 131072, 
+                                -BCD_MAX, BCD_MAX);
+                        field[CODEWORD_av_pb][k] = (int32_t) chroma_index_sum(
+                                t, pb[0][l] + pb[0][r] + pb[1][l] + pb[1][r]);
+                        field[CODEWORD_av_pr][k] = (int32_t) chroma_index_sum(
+                                t, pr[0][l] + pr[0][r] + pr[1][l] + pr[1][r]);
+                }
+
+                bitpackrow_pack(codeword_layout, CODEWORD_NFIELDS, fields, n,
+                        &words[c0]);
+        }
+}
+
+/**************************q15row_to_rgb********************************
+ * 
+ * Parameters:
+ *      const int32_t *y, *pb, *pr: n Q15 values each
+ *      unsigned n: number of pixels
+ *      unsigned char *rgb: 3 * n bytes of r, g, b to be filled in
+ * 
+ * Notes: each component is clamped to [0, 1] and scaled by 255,
+ *      truncating like the float path
+ * 
+ * *******************************************************************/
+static void q15row_to_rgb(const int32_t *y, const int32_t *pb,
+        const int32_t *pr, unsigned n, unsigned char *rgb)
+{
+        for (unsigned i = 0; i < n; i++) {
+                int32_t r = y[i] + floor_shift(R_PR * pr[i] + Q14_ROUND, 14);
+                int32_t g = y[i] - floor_shift(G_PB * pb[i] + G_PR * pr[i] + 
+                        Q14_ROUND, 14);
+                int32_t b = y[i] + floor_shift(B_PB * pb[i] + Q14_ROUND, 14);
+
+                rgb[3 * i] = (unsigned char) 
+                        floor_shift(clamp_int(r, 0, Q15_ONE) * 255, 15);
+                rgb[3 * i + 1] = (unsigned char) 
+                        floor_shift(clamp_int(g, 0, Q15_ONE) * 255, 15);
+                rgb[3 * i + 2] = (unsigned char) 
+                        floor_shift(clamp_int(b, 0, Q15_ONE) * 255, 15);
+        }
+}
+
+/**************************fixedrow_decompress********************************
+ * 
+ * Parameters:
+ *      const uint32_t *words: one row of nblocks code words
+ *      unsigned nblocks: number of 2 by 2 blocks in the block row
+ *      unsigned char *top: first P6 scanline of the block row
+ *      unsigned char *bottom: second P6 scanline of the block row
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: both scanlines hold at least 6 * nblocks bytes
+ * 
+ * Notes: a becomes a * 2^15 / 511, rounded, and b, c, d become
+ *      b * 1057, the nearest integer to 2^15 / 31, before the inverse
+ *      transform in Q15
+ * 
+ * *******************************************************************/
+void fixedrow_decompress(const uint32_t *words, unsigned nblocks,
+        unsigned char *top, unsigned char *bottom)
+{
+        int32_t y[2][2 * CHUNK], pb[2][2 * CHUNK], pr[2][2 * CHUNK];
+        const chroma_table *t = chroma_table_get();
+        int32_t field[CODEWORD_NFIELDS][CHUNK];
+        int32_t *fields[CODEWORD_NFIELDS];
+
+        for (int f = 0; f < CODEWORD_NFIELDS; f++)
+                fields[f] = field[f];
+
+        for (unsigned c0 = 0; c0 < nblocks; c0 += CHUNK) {
+                unsigned n = (nblocks - c0 < CHUNK) ? nblocks - c0 : CHUNK;
+
+                bitpackrow_unpack(codeword_layout, CODEWORD_NFIELDS, 
+                        &words[c0], n, fields);
+
+                for (unsigned k = 0; k < n; k++) {
+                        unsigned l = 2 * k, r = 2 * k + 1;
+                        int32_t a = (field[CODEWORD_a][k] * Q15_ONE + 255) 
+                                / 511;
+                        int32_t b = field[CODEWORD_b][k] * 1057;
+                        int32_t c = field[CODEWORD_c][k] * 1057;
+                        int32_t d = field[CODEWORD_d][k] * 1057;
+                        int32_t cb = t->q15_value[field[CODEWORD_av_pb][k]];
+                        int32_t cr = t->q15_value[field[CODEWORD_av_pr][k]];
+
+                        y[0][l] = clamp_int(a - b - c + d, 0, Q15_ONE);
+                        y[0][r] = clamp_int(a - b + c - d, 0, Q15_ONE);
+                        y[1][l] = clamp_int(a + b - c - d, 0, Q15_ONE);
+                        y[1][r] = clamp_int(a + b + c + d, 0, Q15_ONE);
+                        pb[0][l] = pb[0][r] = pb[1][l] = pb[1][r] = cb;
+                        pr[0][l] = pr[0][r] = pr[1][l] = pr[1][r] = cr;
+                }
+
+                q15row_to_rgb(y[0], pb[0], pr[0], 2 * n, &top[6 * c0]);
+                q15row_to_rgb(y[1], pb[1], pr[1], 2 * n, &bottom[6 * c0]);
+        }
+}
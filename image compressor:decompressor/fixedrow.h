@@ -0,0 +1,64 @@
+/***********************************************************************
+ * 
+ *                      fixedrow.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains function declarations for fixedrow.c,
+ *              the integer-only version of the block row kernels
+ * 
+ ***********************************************************************/
+#ifndef FIXEDROW_INCLUDED
+#define FIXEDROW_INCLUDED
+
+#include <stdint.h>
+#include "pnm.h"
+
+/**************************fixedrow_compress********************************
+ * 
+ * Parameters:
+ *      const unsigned char *top: first pixel row of the block row, as
+ *              P6 samples
+ *      const unsigned char *bottom: second pixel row of the block row
+ *      unsigned nblocks: number of 2 by 2 blocks in the block row
+ *      unsigned denominator: maximum value of an rgb component
+ *      uint32_t *words: array of nblocks code words to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: both rows hold at least 2 * nblocks pixels, denominator from
+ *      1 to 65535
+ * 
+ * Notes: same job as blockrow_compress using only integer arithmetic.
+ *      Compared with blockrow_compress on the same pixels, a differs by
+ *      at most 1, b, c and d by at most 1, and each chroma index by at
+ *      most 1; most words are identical
+ * 
+ * *******************************************************************/
+extern void fixedrow_compress(const unsigned char *top,
+        const unsigned char *bottom, unsigned nblocks, unsigned denominator,
+        uint32_t *words);
+
+/**************************fixedrow_decompress********************************
+ * 
+ * Parameters:
+ *      const uint32_t *words: one row of nblocks code words
+ *      unsigned nblocks: number of 2 by 2 blocks in the block row
+ *      unsigned char *top: first P6 scanline of the block row
+ *      unsigned char *bottom: second P6 scanline of the block row
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: both scanlines hold at least 6 * nblocks bytes
+ * 
+ * Notes: same job as blockrow_decompress using only integer arithmetic.
+ *      Compared with blockrow_decompress on the same words, every r, g
+ *      and b byte differs by at most 1
+ * 
+ * *******************************************************************/
+extern void fixedrow_decompress(const uint32_t *words, unsigned nblocks,
+        unsigned char *top, unsigned char *bottom);
+
+#endif
@@ -9,7 +9,12 @@
  *              a compressed binary image file
  * 
  ***********************************************************************/
+#include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 #include "imageprocessor.h"
+#include "rowloop.h"
 Except_T file_err = { "file is too short" };
 /**************************readppmimage********************************
  * 
@@ -22,29 +27,24 @@ Except_T file_err = { "file is too short" };
  * 
  * Expects: valid file pointer and methods
  * 
- * Notes: the function processes a PPM image by trimming when needed. 
+ * Notes: the function processes a PPM image by trimming an odd last row
+ *      or column. With methods that provide trim the pixels are not
+ *      copied: the array is shrunk in place to the even-sized region
  * 
  * *******************************************************************/
 Pnm_ppm readppmimage(FILE *fp, A2Methods_T methods) {
         Pnm_ppm image = Pnm_ppmread(fp, methods);
-        bool trim = false;
 
-        unsigned width = image->width;
-        unsigned height = image->height;
-
-        if (width % 2 != 0) {
-                (image->width) = (image->width) - 1;
-                width = image->width;
-                trim = true;
-        }
-        if (height % 2 != 0) {
-                (image->height) = (image->height) - 1;
-                height = image->height;
-                trim = true;
+        unsigned width = image->width - image->width % 2;
+        unsigned height = image->height - image->height % 2;
+        if (width == image->width && height == image->height) {
+                return image;
         }
 
-        if (trim) {
-              
+        if (methods->trim != NULL) {
+                /*a view of the even-sized region: no copy, no new array*/
+                methods->trim(image->pixels, width, height);
+        } else {
                 A2Methods_UArray2 new_pixels = methods->new(width, height, 
                         sizeof(struct Pnm_rgb));
                 
@@ -56,105 +56,452 @@ Pnm_ppm readppmimage(FILE *fp, A2Methods_T methods) {
                                 Pnm_rgb new_pix = methods->at(
                                         new_pixels, c, r
                                 );
-                                new_pix->red = old_pix->red;
-                                new_pix->blue = old_pix->blue;
-                                new_pix->green = old_pix->green;
+                                *new_pix = *old_pix;
                         }
                 }
                 methods->free(&(image->pixels));
                 image->pixels = new_pixels;
         }
+        image->width = width;
+        image->height = height;
         return image;
 }
 /**************************print_compressedimg********************************
  * 
  * Parameters:
+ *      FILE *fp: stream the compressed image is printed to
  *      A2Methods_UArray2 arr: 2D array containing coded words
  *     A2Methods_T methods: methods for Uarray2 operations
+ *      bool reserve: whether room for the image may be reserved in fp
+ *      arena mem: arena the row buffer comes from
  * 
  * Return: 
  *      None
  * 
  * Expects: valid 2d array
  * 
- * Notes: the function prints coded words in big-endian order byte by byte
+ * Notes: the function gathers each row of uint32_t coded words and
+ *      prints it in big-endian order through a word_writer; the rows of
+ *      a plain array are printed in place
  * 
  * *******************************************************************/
-void print_compressedimg(A2Methods_UArray2 arr, A2Methods_T methods)
+void print_compressedimg(FILE *fp, A2Methods_UArray2 arr, 
+        A2Methods_T methods, bool reserve, arena mem)
 {
         int width = methods->width(arr);
         int height = methods->height(arr);
+        word_writer writer = wordwriter_new(fp, width * 2, height * 2, 
+                reserve, mem);
 
-        printf("COMP40 Compressed image format 2\n%u %u", width * 2, 
-                height * 2);
-        printf("\n");
+        if (rowloop_plain(methods)) {
+                for (int i = 0; i < height; ++i) {
+                        wordwriter_row(writer, ROWLOOP_ROW(arr, i, uint32_t),
+                                width);
+                }
+                wordwriter_free(&writer);
+                return;
+        }
 
+        uint32_t *row = arena_alloc(mem, ((size_t) width + 1) * 
+                sizeof(*row));
         for(int i = 0; i < height; ++i) {
                 for(int j = 0; j < width; ++j) {
-                        uint64_t *word = methods->at(arr, j, i); 
-                        uint32_t new_word = (uint32_t) (*word);
-
-                        for(int w = 24; w >= 0; w = w - 8) {
-                                unsigned char byte = (new_word >> w);
-                                putchar(byte);
-                        }
-                        
+                        row[j] = *(uint32_t *) methods->at(arr, j, i);
                 }
+                wordwriter_row(writer, row, width);
         }
+
+        wordwriter_free(&writer);
 }
 /**************************code_word********************************
  * 
  * Parameters:
  *      File *fp: A file pointer to an open file of a compressed binary image
  *     A2Methods_T methods: methods for Uarray2 operations
+ *      arena mem: arena the array and the row buffer come from
  * 
  * Return: 
  *      A2Methods_UArray2 of coded bitwords from the file
  * 
  * Expects: valid file pointer and methods
  * 
- * Notes: the function reads the bitwords in a file byte by byte and stores
- *      the words in a 2d array of half the image width and height. The 
- *      function will CRE  when it is shorter than expected or if 
- *      it is an invalid binary file
+ * Notes: the function reads the bitwords a row at a time through a 
+ *      word_reader and stores the words in a 2d array of uint32_t of half
+ *      the image width and height; the rows of a plain array are read
+ *      into in place. The function will CRE when it is shorter than
+ *      expected or if it is an invalid binary file
  * 
  * *******************************************************************/
-A2Methods_UArray2 code_word(FILE *fp, A2Methods_T methods) {
-        unsigned width, height;
-        int read = fscanf(fp, "COMP40 Compressed image format 2\n%u %u", &width,
-                &height);
-        assert(read == 2);
-        int c = getc(fp);
-        assert(c == '\n');
+A2Methods_UArray2 code_word(FILE *fp, A2Methods_T methods, arena mem) {
+        word_reader reader = wordreader_new(fp, true, mem);
+        unsigned width = reader->width / 2;
+        unsigned height = reader->height / 2;
 
-        width /= 2;
-        height /= 2;
+        A2Methods_UArray2 coded_word = arena_array(mem, methods, width, 
+                height, sizeof(uint32_t));
 
-        A2Methods_UArray2 coded_word = methods->new(width, height, 
-                sizeof(uint64_t));
-        unsigned num_words = 0;
-        
+        if (rowloop_plain(methods)) {
+                for (unsigned r = 0; r < height; r++) {
+                        wordreader_row(reader, ROWLOOP_ROW(coded_word, r, 
+                                uint32_t), width);
+                }
+                wordreader_free(&reader);
+                return coded_word;
+        }
+
+        uint32_t *row = arena_alloc(mem, ((size_t) width + 1) * 
+                sizeof(*row));
         for(unsigned r = 0; r < height; r++) {
+                wordreader_row(reader, row, width);
                 for(unsigned c = 0; c < width; c++) {
-                        uint64_t word = 0;
-                        for(int w = 24; w >= 0; w -= 8) {
-                                int byte = getc(fp);
-                                if (byte == EOF) {
-                                        if (num_words < (width * height)) {
-                                                RAISE(file_err);
-                                        }  
-                                }
-                                
-                                uint64_t curr = (uint64_t) byte;
-                                curr = byte << w;
-                                word = word | curr;  
-                        }
-                        
-                        num_words++;
-                        uint64_t *c_word = methods->at(coded_word, c, r);
-                        *c_word = word;
+                        uint32_t *c_word = methods->at(coded_word, c, r);
+                        *c_word = row[c];
                 }
-                
         }
+
+        wordreader_free(&reader);
         return coded_word;
 }
+/**************************read_headernum********************************
+ * 
+ * Parameters:
+ *      File *fp: file pointer inside the header of a PPM image
+ * 
+ * Return: 
+ *      the next unsigned number of the header
+ * 
+ * Expects: valid file pointer
+ * 
+ * Notes: skips whitespace and '#' comments before the number. CRE is
+ *      raised when no number follows
+ * 
+ * *******************************************************************/
+static unsigned read_headernum(FILE *fp)
+{
+        int c = getc(fp);
+        while (c == '#' || isspace(c)) {
+                if (c == '#') {
+                        while (c != '\n' && c != EOF) {
+                                c = getc(fp);
+                        }
+                }
+                c = getc(fp);
+        }
+        assert(isdigit(c));
+
+        unsigned num = 0;
+        while (isdigit(c)) {
+                num = num * 10 + (unsigned) (c - '0');
+                c = getc(fp);
+        }
+        ungetc(c, fp);
+        return num;
+}
+/**************************ppmreader_new********************************
+ * 
+ * Parameters:
+ *      File *fp: file pointer of a PPM image
+ *      arena mem: arena the reader and its row buffers come from
+ *      bool mappable: whether a regular file may be mapped
+ * 
+ * Return: 
+ *      a ppm_reader positioned at the first row of the raster
+ * 
+ * Expects: valid file pointer
+ * 
+ * Notes: the header is parsed from fp, which leaves it at the raster;
+ *      that offset is where the raster starts in the mapping. A file that
+ *      cannot be mapped is read through fp. A P3 raster has no fixed
+ *      size, so only a P6 one is checked up front. CRE is raised when the
+ *      header is invalid or malloc fails
+ * 
+ * *******************************************************************/
+ppm_reader ppmreader_new(FILE *fp, arena mem, bool mappable)
+{
+        assert(fp != NULL);
+        int magic = getc(fp);
+        int format = getc(fp);
+        assert(magic == 'P' && (format == '3' || format == '6'));
+
+        ppm_reader reader = arena_alloc(mem, sizeof(*reader));
+
+        reader->fp = fp;
+        reader->plain = (format == '3');
+        reader->width = read_headernum(fp);
+        reader->height = read_headernum(fp);
+        reader->denominator = read_headernum(fp);
+        assert(reader->denominator > 0 && reader->denominator <= 65535);
+
+        /*a single whitespace character separates the header from a raw
+         raster*/
+        int c = getc(fp);
+        assert(isspace(c));
+
+        size_t sample = (reader->denominator < 256) ? 1 : 2;
+        reader->rowbytes = (size_t) reader->width * 3 * sample;
+        reader->flip = 0;
+
+        reader->map = NULL;
+        reader->maplen = 0;
+        reader->next = NULL;
+        struct stat st;
+        off_t start = ftello(fp);
+        bool regular = start >= 0 && fstat(fileno(fp), &st) == 0 && 
+                S_ISREG(st.st_mode);
+        if (regular && !reader->plain && (uint64_t) st.st_size < 
+            (uint64_t) start + (uint64_t) reader->rowbytes * reader->height) {
+                RAISE(file_err);
+        }
+        if (mappable && regular && st.st_size > start) {
+                void *map = mmap(NULL, (size_t) st.st_size, PROT_READ,
+                        MAP_PRIVATE, fileno(fp), 0);
+                if (map != MAP_FAILED) {
+                        (void) madvise(map, (size_t) st.st_size, 
+                                MADV_SEQUENTIAL);
+                        reader->map = map;
+                        reader->maplen = (size_t) st.st_size;
+                        reader->next = reader->map + start;
+                }
+        }
+
+        /*row buffers, unless every row is a view of the mapping*/
+        reader->raw[0] = reader->raw[1] = NULL;
+        if (!ppmreader_views(reader)) {
+                reader->raw[0] = arena_alloc(mem, reader->rowbytes);
+                reader->raw[1] = arena_alloc(mem, reader->rowbytes);
+        }
+        return reader;
+}
+/**************************scan_mapped********************************
+ * 
+ * Parameters:
+ *      ppm_reader reader: reader of a mapped P3 image
+ * 
+ * Return: 
+ *      the next number of the raster
+ * 
+ * Expects: valid reader with a mapping
+ * 
+ * Notes: skips whitespace, then reads decimal digits straight out of the
+ *      mapping. The function will CRE when the raster ends early
+ * 
+ * *******************************************************************/
+static unsigned scan_mapped(ppm_reader reader)
+{
+        const unsigned char *p = reader->next;
+        const unsigned char *end = reader->map + reader->maplen;
+
+        while (p < end && isspace(*p)) {
+                p++;
+        }
+        if (p == end || !isdigit(*p)) {
+                RAISE(file_err);
+        }
+        unsigned num = 0;
+        while (p < end && isdigit(*p) && num <= 65535) {
+                num = num * 10 + (unsigned) (*p - '0');
+                p++;
+        }
+        reader->next = p;
+        return num;
+}
+/**************************scan_file********************************
+ * 
+ * Parameters:
+ *      ppm_reader reader: reader of a P3 image that is not mapped
+ * 
+ * Return: 
+ *      the next number of the raster
+ * 
+ * Expects: valid reader
+ * 
+ * Notes: same as scan_mapped, reading with getc_unlocked
+ * 
+ * *******************************************************************/
+static unsigned scan_file(ppm_reader reader)
+{
+        int c = getc_unlocked(reader->fp);
+        while (c != EOF && isspace(c)) {
+                c = getc_unlocked(reader->fp);
+        }
+        if (c == EOF || !isdigit(c)) {
+                RAISE(file_err);
+        }
+        unsigned num = 0;
+        while (isdigit(c) && num <= 65535) {
+                num = num * 10 + (unsigned) (c - '0');
+                c = getc_unlocked(reader->fp);
+        }
+        ungetc(c, reader->fp);
+        return num;
+}
+/**************************ppmreader_row********************************
+ * 
+ * Parameters:
+ *      ppm_reader reader: reader returned by ppmreader_new
+ * 
+ * Return: 
+ *      the next row of the raster: reader->rowbytes bytes of P6 samples
+ * 
+ * Expects: valid reader, and at most reader->height calls
+ * 
+ * Notes: a P3 row is parsed into P6 layout so every caller sees one
+ *      format. The function will CRE when the file is shorter than its
+ *      header says or a P3 sample is larger than the denominator
+ * 
+ * *******************************************************************/
+const unsigned char *ppmreader_row(ppm_reader reader)
+{
+        assert(reader != NULL);
+        size_t rowbytes = reader->rowbytes;
+
+        if (!reader->plain && reader->map != NULL) {
+                if ((size_t) (reader->map + reader->maplen - reader->next) <
+                    rowbytes) {
+                        RAISE(file_err);
+                }
+                const unsigned char *row = reader->next;
+                reader->next += rowbytes;
+                return row;
+        }
+
+        unsigned char *row = reader->raw[reader->flip];
+        reader->flip ^= 1;
+        if (!reader->plain) {
+                size_t got = fread(row, 1, rowbytes, reader->fp);
+                if (got != rowbytes) {
+                        RAISE(file_err);
+                }
+                return row;
+        }
+
+        bool wide = (reader->denominator > 255);
+        unsigned samples = reader->width * 3;
+        for (unsigned i = 0; i < samples; i++) {
+                unsigned v = (reader->map != NULL) ? scan_mapped(reader) :
+                                                     scan_file(reader);
+                assert(v <= reader->denominator);
+                if (wide) {
+                        row[2 * i] = (unsigned char) (v >> 8);
+                        row[2 * i + 1] = (unsigned char) v;
+                } else {
+                        row[i] = (unsigned char) v;
+                }
+        }
+        return row;
+}
+
+/**************************ppmreader_views********************************
+ * 
+ * Parameters:
+ *      ppm_reader reader: reader returned by ppmreader_new
+ * 
+ * Return: 
+ *      true when the rows are views into the mapped file
+ * 
+ * Expects: valid reader
+ * 
+ * *******************************************************************/
+bool ppmreader_views(ppm_reader reader)
+{
+        assert(reader != NULL);
+        return !reader->plain && reader->map != NULL;
+}
+
+/**************************ppmreader_free********************************
+ * 
+ * Parameters:
+ *      ppm_reader *reader: pointer to the reader to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to a reader
+ * 
+ * Notes: unmaps the file and clears the pointer; the memory goes back
+ *      with its arena. The file is not closed
+ * 
+ * *******************************************************************/
+void ppmreader_free(ppm_reader *reader)
+{
+        assert(reader != NULL && *reader != NULL);
+        if ((*reader)->map != NULL) {
+                munmap((*reader)->map, (*reader)->maplen);
+        }
+        *reader = NULL;
+}
+/**************************read_compressedheader*****************************
+ * 
+ * Parameters:
+ *      File *fp: A file pointer to an open file of a compressed binary image
+ *      unsigned *width: set to the width of the image in pixels
+ *      unsigned *height: set to the height of the image in pixels
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid file pointer and pointers
+ * 
+ * Notes: reads the header of a compressed binary image, leaving fp at the
+ *      first code word. CRE is raised when the header is invalid
+ * 
+ * *******************************************************************/
+void read_compressedheader(FILE *fp, unsigned *width, unsigned *height)
+{
+        int read = fscanf(fp, "COMP40 Compressed image format 2\n%u %u", width,
+                height);
+        assert(read == 2);
+        int c = getc(fp);
+        assert(c == '\n');
+}
+/**************************print_ppmheader********************************
+ * 
+ * Parameters:
+ *      FILE *fp: stream the header is printed to
+ *      unsigned width: width of the image in pixels
+ *      unsigned height: height of the image in pixels
+ *      bool reserve: whether room for the image may be reserved in fp
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: None
+ * 
+ * Notes: prints the header of a P6 image with denominator 255 to fp,
+ *      in the same form as Pnm_ppmwrite, after reserving room for the
+ *      whole image with reserve_output when reserve is set
+ * 
+ * *******************************************************************/
+void print_ppmheader(FILE *fp, unsigned width, unsigned height, 
+        bool reserve)
+{
+        char header[64];
+        int hlen = snprintf(header, sizeof(header), "P6\n%u %u\n%u\n", 
+                width, height, 255);
+        assert(hlen > 0 && (size_t) hlen < sizeof(header));
+        if (reserve) {
+                reserve_output(fp, (uint64_t) hlen + 
+                        (uint64_t) width * height * 3);
+        }
+        fputs(header, fp);
+}
+/**************************print_ppmrow********************************
+ * 
+ * Parameters:
+ *      FILE *fp: stream the scanline is printed to
+ *      const unsigned char *row: interleaved r, g, b bytes of a scanline
+ *      unsigned width: number of pixels in the scanline
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid array of 3 * width bytes
+ * 
+ * Notes: prints one finished P6 scanline to fp
+ * 
+ * *******************************************************************/
+void print_ppmrow(FILE *fp, const unsigned char *row, unsigned width)
+{
+        size_t written = fwrite(row, 3, width, fp);
+        assert(written == width);
+}
@@ -14,6 +14,27 @@
 #include <assert.h>
 #include "pnm.h"
 #include "a2methods.h"
+#include "wordio.h"
+#include "arena.h"
+
+/*a PPM image read one row at a time: the header is parsed up front and
+ the raster is left in the file until each row is asked for. Rows are
+ handed out in P6 layout, one byte per sample when the denominator is
+ below 256 and two big-endian bytes otherwise. A regular file is mapped
+ and P6 rows point straight into the mapping*/
+typedef struct ppm_reader {
+        FILE *fp;
+        unsigned width;
+        unsigned height;
+        unsigned denominator;
+        bool plain;             /*P3 ascii raster instead of P6 bytes*/
+        size_t rowbytes;        /*bytes in a row of P6 samples*/
+        unsigned char *raw[2];  /*rows read or parsed when not a view*/
+        unsigned flip;          /*raw row to use next*/
+        unsigned char *map;     /*whole file, or NULL when not mapped*/
+        size_t maplen;
+        const unsigned char *next;      /*first unread byte of map*/
+} *ppm_reader;
 
 /**************************readppmimage********************************
  * 
@@ -26,7 +47,9 @@
  * 
  * Expects: valid file pointer and methods
  * 
- * Notes: the function processes a PPM image by trimming when needed. 
+ * Notes: the function processes a PPM image by trimming an odd last row
+ *      or column. With methods that provide trim the pixels are not
+ *      copied: the array is shrunk in place to the even-sized region
  * 
  * *******************************************************************/
 extern Pnm_ppm readppmimage(FILE *fp, A2Methods_T methods);
@@ -36,32 +59,169 @@ extern Pnm_ppm readppmimage(FILE *fp, A2Methods_T methods);
  * Parameters:
  *      File *fp: A file pointer to an open file of a compressed binary image
  *     A2Methods_T methods: methods for Uarray2 operations
+ *      arena mem: arena the array and the row buffer come from
  * 
  * Return: 
  *      A2Methods_UArray2 of coded bitwords from the file
  * 
  * Expects: valid file pointer and methods
  * 
- * Notes: the function reads the bitwords in a file byte by byte and stores
- *      the words in a 2d array of half the image width and height. The 
- *      function will CRE  when it is shorter than expected or if 
- *      it is an invalid binary file
+ * Notes: the function reads the bitwords a row at a time through a 
+ *      word_reader and stores the words in a 2d array of uint32_t of half
+ *      the image width and height. The function will CRE when it is
+ *      shorter than expected or if it is an invalid binary file
  * 
  * *******************************************************************/
-extern A2Methods_UArray2 code_word(FILE *fp, A2Methods_T methods);
+extern A2Methods_UArray2 code_word(FILE *fp, A2Methods_T methods, 
+        arena mem);
 
 /**************************print_compressedimg********************************
  * 
  * Parameters:
+ *      FILE *fp: stream the compressed image is printed to
  *      A2Methods_UArray2 arr: 2D array containing coded words
  *     A2Methods_T methods: methods for Uarray2 operations
+ *      bool reserve: whether room for the image may be reserved in fp
+ *      arena mem: arena the row buffer comes from
  * 
  * Return: 
  *      None
  * 
  * Expects: valid 2d array
  * 
- * Notes: the function prints coded words in big-endian order byte by byte
+ * Notes: the function gathers each row of uint32_t coded words and
+ *      prints it in big-endian order through a word_writer
+ * 
+ * *******************************************************************/
+extern void print_compressedimg(FILE *fp, A2Methods_UArray2 arr, 
+        A2Methods_T methods, bool reserve, arena mem);
+
+/**************************ppmreader_new********************************
+ * 
+ * Parameters:
+ *      File *fp: file pointer of a PPM image
+ *      arena mem: arena the reader and its row buffers come from
+ *      bool mappable: whether a regular file may be mapped
+ * 
+ * Return: 
+ *      a ppm_reader positioned at the first row of the raster
+ * 
+ * Expects: valid file pointer
+ * 
+ * Notes: reads the header of a P3 or P6 image with any denominator from
+ *      1 to 65535, and maps the file when it is a regular file and
+ *      mappable so the first row is ready without reading the rest. The
+ *      pages of a mapping count against the memory of the process, so a
+ *      run under a memory budget reads rows instead. The size of a
+ *      regular P6 file is checked against the header before any row is
+ *      read, raising file_err when it is too short. CRE is raised when
+ *      the header is invalid or malloc fails
+ * 
+ * *******************************************************************/
+extern ppm_reader ppmreader_new(FILE *fp, arena mem, bool mappable);
+
+/**************************ppmreader_row********************************
+ * 
+ * Parameters:
+ *      ppm_reader reader: reader returned by ppmreader_new
+ * 
+ * Return: 
+ *      the next row of the raster: reader->rowbytes bytes of P6 samples
+ * 
+ * Expects: valid reader, and at most reader->height calls
+ * 
+ * Notes: for a mapped P6 file the row is a view into the mapping and no
+ *      bytes are copied; otherwise it is read or parsed into one of two
+ *      buffers. Either way a row stays valid until two more rows have
+ *      been read, and a view stays valid until the reader is freed.
+ *      The function will CRE when the file is shorter than its header
+ *      says or a P3 sample is not a number up to the denominator
+ * 
+ * *******************************************************************/
+extern const unsigned char *ppmreader_row(ppm_reader reader);
+
+/**************************ppmreader_views********************************
+ * 
+ * Parameters:
+ *      ppm_reader reader: reader returned by ppmreader_new
+ * 
+ * Return: 
+ *      true when every row returned by ppmreader_row is a view into the
+ *      mapped file, so it stays valid until the reader is freed
+ * 
+ * Expects: valid reader
+ * 
+ * *******************************************************************/
+extern bool ppmreader_views(ppm_reader reader);
+
+/**************************ppmreader_free********************************
+ * 
+ * Parameters:
+ *      ppm_reader *reader: pointer to the reader to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to a reader
+ * 
+ * Notes: unmaps the file and clears the pointer; the memory goes back
+ *      with its arena. The file is not closed
+ * 
+ * *******************************************************************/
+extern void ppmreader_free(ppm_reader *reader);
+
+/**************************read_compressedheader*****************************
+ * 
+ * Parameters:
+ *      File *fp: A file pointer to an open file of a compressed binary image
+ *      unsigned *width: set to the width of the image in pixels
+ *      unsigned *height: set to the height of the image in pixels
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid file pointer and pointers
+ * 
+ * Notes: reads the header of a compressed binary image, leaving fp at the
+ *      first code word. CRE is raised when the header is invalid
+ * 
+ * *******************************************************************/
+extern void read_compressedheader(FILE *fp, unsigned *width, 
+        unsigned *height);
+
+/**************************print_ppmheader********************************
+ * 
+ * Parameters:
+ *      FILE *fp: stream the header is printed to
+ *      unsigned width: width of the image in pixels
+ *      unsigned height: height of the image in pixels
+ *      bool reserve: whether room for the image may be reserved in fp
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: None
+ * 
+ * Notes: prints the header of a P6 image with denominator 255 to fp
+ * 
+ * *******************************************************************/
+extern void print_ppmheader(FILE *fp, unsigned width, unsigned height,
+        bool reserve);
+
+/**************************print_ppmrow********************************
+ * 
+ * Parameters:
+ *      FILE *fp: stream the scanline is printed to
+ *      const unsigned char *row: interleaved r, g, b bytes of a scanline
+ *      unsigned width: number of pixels in the scanline
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid array of 3 * width bytes
+ * 
+ * Notes: prints one finished P6 scanline to fp
  * 
  * *******************************************************************/
-extern void print_compressedimg(A2Methods_UArray2 arr, A2Methods_T methods);
\ No newline at end of file
+extern void print_ppmrow(FILE *fp, const unsigned char *row, 
+        unsigned width);
\ No newline at end of file
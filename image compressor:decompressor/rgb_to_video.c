@@ -10,30 +10,91 @@
  ***********************************************************************/
 
 #include "rgb_to_video.h"
+#include "codec40.h"
+#include "colorconv.h"
+#include "rowloop.h"
 #define DENOMINATOR 255
-/**********************get_range******************************
+
+/*pixels handled per pass by vcs_rows; its byte buffer fits in L1*/
+#define CHUNK 128
+
+/*the closure of the row loops: the rgb pixels, the planes and the
+ denominator of the rgb pixels*/
+typedef struct plane_rows {
+        A2Methods_UArray2 rgb;
+        vcs_planes planes;
+        unsigned denominator;
+} plane_rows;
+
+/*rgb_to_videocs on plain arrays: rows first to last - 1*/
+static void rgb_rows(unsigned first, unsigned last, void *cl)
+{
+        plane_rows *rows = cl;
+        int width = UArray2_width((UArray2_T) rows->rgb);
+        for (unsigned j = first; j < last; j++) {
+                const struct Pnm_rgb *rgb = ROWLOOP_ROW(rows->rgb, j, 
+                        struct Pnm_rgb);
+                float *y = ROWLOOP_ROW(rows->planes.y, j, float);
+                float *pb = ROWLOOP_ROW(rows->planes.pb, j, float);
+                float *pr = ROWLOOP_ROW(rows->planes.pr, j, float);
+                for (int i = 0; i < width; i++) {
+                        struct color_space cs;
+                        rgb_to_cs(&rgb[i], rows->denominator, &cs);
+                        y[i] = cs.y;
+                        pb[i] = cs.pb;
+                        pr[i] = cs.pr;
+                }
+        }
+}
+
+/*vidcs_to_rgb on plain arrays: rows first to last - 1. The three plane
+ rows are read with unit stride by vcsrow_to_rgb, whose bytes are the
+ ones cs_to_rgb gives for DENOMINATOR*/
+static void vcs_rows(unsigned first, unsigned last, void *cl)
+{
+        plane_rows *rows = cl;
+        unsigned width = (unsigned) UArray2_width((UArray2_T) rows->rgb);
+        unsigned char bytes[3 * CHUNK];
+        for (unsigned j = first; j < last; j++) {
+                const float *y = ROWLOOP_ROW(rows->planes.y, j, float);
+                const float *pb = ROWLOOP_ROW(rows->planes.pb, j, float);
+                const float *pr = ROWLOOP_ROW(rows->planes.pr, j, float);
+                struct Pnm_rgb *rgb = ROWLOOP_ROW(rows->rgb, j, 
+                        struct Pnm_rgb);
+                for (unsigned i0 = 0; i0 < width; i0 += CHUNK) {
+                        unsigned n = (width - i0 < CHUNK) ? width - i0 
+                                                          : CHUNK;
+                        vcsrow_to_rgb(&y[i0], &pb[i0], &pr[i0], n, bytes);
+                        for (unsigned i = 0; i < n; i++) {
+                                rgb[i0 + i].red = bytes[3 * i];
+                                rgb[i0 + i].green = bytes[3 * i + 1];
+                                rgb[i0 + i].blue = bytes[3 * i + 2];
+                        }
+                }
+        }
+}
+
+/**************************vcs_planes_new********************************
  * 
  * Parameters:
- *      float value: value to check if is in the low to high range
- *      float low: low limit of the allowed range
- *      float high: high limit of the allowed range
+ *      arena mem: arena the planes come from
+ *      A2Methods_T methods: methods the planes are made and used by
+ *      int width, height: size of the image in pixels
  * 
  * Return: 
- *      returns a value in the specified range
- * 
- * Expects: valid value, low and high floats
+ *      new y, pb and pr planes of floats, width by height
  * 
- * Notes: get_range determines if y, pb and pr are in the required
- *      range
+ * Expects: valid arena and methods
  * 
- *******************************************************************/
-static float get_range(float value, float low, float high) {
-        if (value < low) {
-                return low;
-        } else if (value > high) {
-                return high;
-        }
-        return value;
+ * *******************************************************************/
+vcs_planes vcs_planes_new(arena mem, A2Methods_T methods, int width,
+        int height)
+{
+        vcs_planes planes;
+        planes.y = arena_array(mem, methods, width, height, sizeof(float));
+        planes.pb = arena_array(mem, methods, width, height, sizeof(float));
+        planes.pr = arena_array(mem, methods, width, height, sizeof(float));
+        return planes;
 }
 /**************************rgb_to_videocs********************************
  * 
@@ -41,42 +102,46 @@ static float get_range(float value, float low, float high) {
  *      Pnm_ppm image: ppm image to be compressed
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 video_cs whose elements are structs containing
- *       the component video color space variables
+ *      returns the y, pb and pr planes of the image, each a UArray_2
+ *      of floats
  * 
  * Expects: valid ppm image, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
  *      deals with converting Pnm_rgb  pixels to the component video
- *      color space
+ *      color space. Plain arrays are converted a row at a time, without
+ *      a call per pixel
  * 
  * *******************************************************************/
-A2Methods_UArray2 rgb_to_videocs(Pnm_ppm image, A2Methods_T methods,
-        A2Methods_mapfun *map)
+vcs_planes rgb_to_videocs(Pnm_ppm image, A2Methods_T methods,
+        A2Methods_mapfun *map, arena mem)
 {
         int width = methods->width(image->pixels);
         int height = methods->height(image->pixels);
 
-        A2Methods_UArray2 arr = methods->new(width, height, 
-                sizeof(struct color_space));
+        vcs_planes planes = vcs_planes_new(mem, methods, width, height);
 
-        a2_cl cl = malloc(sizeof(struct a2_cl));
+        if (rowloop_plain(methods)) {
+                plane_rows rows = { image->pixels, planes, 
+                        image->denominator };
+                rowloop_run(methods, map, (unsigned) height, rgb_rows, &rows);
+                return planes;
+        }
+
+        a2_cl cl = arena_alloc(mem, sizeof(struct a2_cl));
         assert(cl != NULL);
         
         cl->methods = methods;
-        cl->array = arr;
+        cl->planes = planes;
         cl->denominator = image->denominator;
 
         map(image->pixels, transform_rgbpixels, cl);
 
-        if(cl != NULL) {
-                free(cl);
-                cl = NULL;
-        }
 
-        return arr;
+        return planes;
 }
 /**************************transform_rgbpixels********************************
  * 
@@ -85,8 +150,8 @@ A2Methods_UArray2 rgb_to_videocs(Pnm_ppm image, A2Methods_T methods,
  *      int row: row index of Pnm_rgb pixel to be transformed
  *      A2Methods_UArray2 arr: 2D array containing Pnm_rgb pixels
  *      void *elem: Pnm_rgb pixel
- *      void *cl: a struct containing methods, denominator and a UArray_2 for
- *              component video color space
+ *      void *cl: a struct containing methods, denominator and the planes
+ *              of the component video color space
  * 
  * Return: 
  *      None
@@ -104,66 +169,56 @@ void transform_rgbpixels(int col, int row, A2Methods_UArray2 arr, void *elem,
 {
         (void) arr;
         a2_cl temp = cl;
-        float y, pb, pr;
-
-        /*getting the rgb pixels*/
-        Pnm_rgb pixel = elem;
-        unsigned int r = pixel->red;
-        unsigned int g = pixel->green;
-        unsigned int b = pixel->blue;
-
-        /*getting y, pb and pr*/
-        color_space temp_cs =  temp->methods->at(temp->array, col, row);
-
-        y = (0.299 * r + 0.587 * g + 0.114 * b) /temp->denominator;
-        temp_cs->y = get_range(y, 0, 1);
-        pb = (-0.168736 * r - 0.331264 * g + 0.5 * b) /temp->denominator;
-        temp_cs->pb = get_range(pb, -0.5, 0.5);
-        pr = (0.5 * r - 0.418688 * g - 0.081312 * b) /temp->denominator;
-        temp_cs->pr = get_range(pr, -0.5, 0.5);
 
+        /*getting y, pb and pr from the rgb pixel*/
+        struct color_space temp_cs;
+        rgb_to_cs(elem, temp->denominator, &temp_cs);
+        vcs_planes_put(temp->methods, temp->planes, col, row, &temp_cs);
 }
 /**************************vidcs_to_rgb********************************
  * 
  * Parameters: 
- *      A2Methods_UArray2 video_cs: UArray2 whose elements are structs 
- *        containing the component video color space variables
+ *      vcs_planes video_cs: y, pb and pr planes of the component video
+ *        color space
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
  *      returns a UArray_2 whose elements are structs containing the
  *        component rgb values
  * 
- * Expects: UArray_2 whose elements are color_space structs, methods, and 
-*           map
+ * Expects: planes of floats of the same size, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
- *      deals with converting the component video color space to Pnm_rgb  pixels
+ *      deals with converting the component video color space to Pnm_rgb
+ *      pixels. Plain arrays are converted a row at a time by the
+ *      vectorized vcsrow_to_rgb, without a call per pixel
  * 
  * *******************************************************************/
-A2Methods_UArray2 vidcs_to_rgb(A2Methods_UArray2 video_cs, A2Methods_T methods,
-        A2Methods_mapfun *map)
+A2Methods_UArray2 vidcs_to_rgb(vcs_planes video_cs, A2Methods_T methods,
+        A2Methods_mapfun *map, arena mem)
 {
-        int width = methods->width(video_cs);
-        int height = methods->height(video_cs);
+        int width = methods->width(video_cs.y);
+        int height = methods->height(video_cs.y);
+
+        A2Methods_UArray2 arr = arena_array(mem, methods, width, 
+                height, sizeof(struct Pnm_rgb));
 
-        A2Methods_UArray2 arr = methods->new(width, height, 
-                sizeof(struct Pnm_rgb));
+        if (rowloop_plain(methods)) {
+                plane_rows rows = { arr, video_cs, DENOMINATOR };
+                rowloop_run(methods, map, (unsigned) height, vcs_rows, &rows);
+                return arr;
+        }
         
-        a2_cl cl = malloc(sizeof(struct a2_cl));
+        a2_cl cl = arena_alloc(mem, sizeof(struct a2_cl));
         assert(cl != NULL);
 
         cl->methods = methods;
-        cl->array = arr;
+        cl->planes = video_cs;
         cl->denominator = DENOMINATOR;
 
-        map(video_cs, transform_vcspixels, cl);
-
-        if(cl != NULL) {
-                free(cl);
-                cl = NULL;
-        }
+        map(arr, transform_vcspixels, cl);
 
         return arr;
 
@@ -171,12 +226,12 @@ A2Methods_UArray2 vidcs_to_rgb(A2Methods_UArray2 video_cs, A2Methods_T methods,
 /**************************transform_vcspixels********************************
  * 
  * Parameters:
- *      int col: col index of color_space pixel to be transformed 
- *      int row: row index of color_space pixel to be transformed
- *      A2Methods_UArray2 arr: 2D array containing color_space pixels
- *      void *elem: color_space pixel
- *      void *cl: a struct containing methods, denominator and a UArray_2 for
- *              component video color space
+ *      int col: col index of the Pnm_rgb pixel to be filled in
+ *      int row: row index of the Pnm_rgb pixel to be filled in
+ *      A2Methods_UArray2 arr: 2D array containing Pnm_rgb pixels
+ *      void *elem: Pnm_rgb pixel
+ *      void *cl: a struct containing methods, denominator and the planes
+ *              of the component video color space
  * 
  * Return: 
  *      None
@@ -193,23 +248,11 @@ void transform_vcspixels(int col, int row, A2Methods_UArray2 arr, void *elem,
         void *cl)
 {
         (void) arr;
-        /*cl is a struct of array, denominator and methods for RGB pixels*/
+        /*cl is a struct of planes, denominator and methods*/
         a2_cl temp = cl;
 
-        /*getting float rgb pixels r, g, b*/
-        color_space cs_pix = elem;
-        float r, g, b;
-        r = 1.0 * cs_pix->y + 0.0 * cs_pix->pb + 1.402 * cs_pix->pr;
-        g = 1.0 * cs_pix->y - 0.344136 * cs_pix->pb - 0.714136 * cs_pix->pr;
-        b = 1.0 * cs_pix->y + 1.772 * cs_pix->pb + 0.0 * cs_pix->pr;
-        
-        /*populating 2d array of rgb pixels at a given col and row*/
-        Pnm_rgb rgb_pix = temp->methods->at(temp->array, col, row);
-        r = get_range(r, 0.0, 1.0);
-        rgb_pix->red = (unsigned) (r * temp->denominator);
-        g = get_range(g, 0.0, 1.0);
-        rgb_pix->green = (unsigned) (g * temp->denominator);
-        b = get_range(b, 0.0, 1.0);
-        rgb_pix->blue = (unsigned) (b * temp->denominator);
-
+        /*populating the rgb pixel from the planes at col and row*/
+        struct color_space cs;
+        vcs_planes_get(temp->methods, temp->planes, col, row, &cs);
+        cs_to_rgb(&cs, temp->denominator, elem);
 }
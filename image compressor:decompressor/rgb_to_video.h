@@ -13,6 +13,7 @@
 #ifndef RGB_TO_VIDEO_INCLUDED
 #define RGB_TO_VIDEO_INCLUDED
 #include "a2methods.h"
+#include "arena.h"
 #include "pnm.h"
 #include "assert.h"
 #include <stdio.h>
@@ -26,24 +27,95 @@ typedef struct color_space {
         float pr;
 } *color_space;
 
+/*an image in component video color space as three planes, one float
+ per pixel in each, so a row of any one component is contiguous*/
+typedef struct vcs_planes {
+        A2Methods_UArray2 y;
+        A2Methods_UArray2 pb;
+        A2Methods_UArray2 pr;
+} vcs_planes;
+
 /*struct passed as a closure in the mapping functions
- it contains a UArray_2 array, methods and denominator*/
+ it contains the planes, methods and denominator*/
 typedef struct a2_cl {
-        A2Methods_UArray2 array;
+        vcs_planes planes;
         A2Methods_T methods;
         unsigned int denominator;
 } *a2_cl;
 
+/**************************vcs_planes_new********************************
+ * 
+ * Parameters:
+ *      arena mem: arena the planes come from
+ *      A2Methods_T methods: methods the planes are made and used by
+ *      int width, height: size of the image in pixels
+ * 
+ * Return: 
+ *      new y, pb and pr planes of floats, width by height
+ * 
+ * Expects: valid arena and methods
+ * 
+ * Notes: the planes live until the arena is reset
+ * 
+ * *******************************************************************/
+extern vcs_planes vcs_planes_new(arena mem, A2Methods_T methods, int width,
+        int height);
+
+/**************************vcs_planes_get********************************
+ * 
+ * Parameters:
+ *      A2Methods_T methods: methods of the planes
+ *      vcs_planes planes: component video planes
+ *      int col, row: pixel to be read
+ *      color_space cs: filled in with y, pb and pr of the pixel
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid planes, col and row, and cs
+ * 
+ * *******************************************************************/
+static inline void vcs_planes_get(A2Methods_T methods, vcs_planes planes,
+        int col, int row, color_space cs)
+{
+        cs->y = *(float *) methods->at(planes.y, col, row);
+        cs->pb = *(float *) methods->at(planes.pb, col, row);
+        cs->pr = *(float *) methods->at(planes.pr, col, row);
+}
+
+/**************************vcs_planes_put********************************
+ * 
+ * Parameters:
+ *      A2Methods_T methods: methods of the planes
+ *      vcs_planes planes: component video planes
+ *      int col, row: pixel to be written
+ *      const struct color_space *cs: y, pb and pr of the pixel
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid planes, col and row, and cs
+ * 
+ * *******************************************************************/
+static inline void vcs_planes_put(A2Methods_T methods, vcs_planes planes,
+        int col, int row, const struct color_space *cs)
+{
+        *(float *) methods->at(planes.y, col, row) = cs->y;
+        *(float *) methods->at(planes.pb, col, row) = cs->pb;
+        *(float *) methods->at(planes.pr, col, row) = cs->pr;
+}
+
 /**************************rgb_to_videocs********************************
  * 
  * Parameters: 
  *      Pnm_ppm image: ppm image to be compressed
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 video_cs whose elements are structs containing
- *       the component video color space variables
+ *      returns the y, pb and pr planes of the image, each a UArray_2
+ *      of floats
  * 
  * Expects: valid ppm image, methods, and map
  * 
@@ -52,8 +124,8 @@ typedef struct a2_cl {
  *      color space
  * 
  * *******************************************************************/
-extern A2Methods_UArray2 rgb_to_videocs(Pnm_ppm image, A2Methods_T methods,
-        A2Methods_mapfun *map);
+extern vcs_planes rgb_to_videocs(Pnm_ppm image, A2Methods_T methods,
+        A2Methods_mapfun *map, arena mem);
 
 /**************************transform_rgbpixels********************************
  * 
@@ -62,8 +134,8 @@ extern A2Methods_UArray2 rgb_to_videocs(Pnm_ppm image, A2Methods_T methods,
  *      int row: row index of Pnm_rgb pixel to be transformed
  *      A2Methods_UArray2 arr: 2D array containing Pnm_rgb pixels
  *      void *elem: Pnm_rgb pixel
- *      void *cl: a struct containing methods, denominator and a UArray_2 for
- *              component video color space
+ *      void *cl: a struct containing methods, denominator and the planes
+ *              of the component video color space
  * 
  * Return: 
  *      None
@@ -82,34 +154,34 @@ extern void transform_rgbpixels(int col, int row, A2Methods_UArray2 arr,
 /**************************vidcs_to_rgb********************************
  * 
  * Parameters: 
- *      A2Methods_UArray2 video_cs: UArray2 whose elements are structs 
- *        containing the component video color space variables
+ *      vcs_planes video_cs: y, pb and pr planes of the component video
+ *        color space
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
  *      returns a UArray_2 whose elements are structs containing the
  *        component rgb values
  * 
- * Expects: UArray_2 whose elements are color_space structs, methods, and 
-*           map
+ * Expects: planes of floats of the same size, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
  *      deals with converting the component video color space to Pnm_rgb  pixels
  * 
  * *******************************************************************/
-extern A2Methods_UArray2 vidcs_to_rgb(A2Methods_UArray2 video_cs, 
-        A2Methods_T methods, A2Methods_mapfun *map);
+extern A2Methods_UArray2 vidcs_to_rgb(vcs_planes video_cs, 
+        A2Methods_T methods, A2Methods_mapfun *map, arena mem);
 
 /**************************transform_vcspixels********************************
  * 
  * Parameters:
- *      int col: col index of color_space pixel to be transformed 
- *      int row: row index of color_space pixel to be transformed
- *      A2Methods_UArray2 arr: 2D array containing color_space pixels
- *      void *elem: color_space pixel
- *      void *cl: a struct containing methods, denominator and a UArray_2 for
- *              component video color space
+ *      int col: col index of the Pnm_rgb pixel to be filled in
+ *      int row: row index of the Pnm_rgb pixel to be filled in
+ *      A2Methods_UArray2 arr: 2D array containing Pnm_rgb pixels
+ *      void *elem: Pnm_rgb pixel
+ *      void *cl: a struct containing methods, denominator and the planes
+ *              of the component video color space
  * 
  * Return: 
  *      None
@@ -0,0 +1,74 @@
+/***********************************************************************
+ *
+ *                      rowloop.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the fast path of the staged pipeline
+ *              for plain arrays: a stage walks whole rows with typed
+ *              pointers and calls the codec40.h arithmetic directly, so
+ *              the compiler can inline it, instead of paying an indirect
+ *              apply call and indirect at calls for every cell. Stages
+ *              fall back to the A2Methods map for any other methods
+ *
+ ***********************************************************************/
+#ifndef ROWLOOP_INCLUDED
+#define ROWLOOP_INCLUDED
+
+#include <stdbool.h>
+#include "a2methods.h"
+#include "a2plain.h"
+#include "threadpool.h"
+#include "uarray2.h"
+
+/*row j of a plain array as a pointer to its first cell of type type*/
+#define ROWLOOP_ROW(array, j, type) \
+        ((type *) UArray2_row((UArray2_T) (array), (j)))
+
+/**************************rowloop_plain********************************
+ *
+ * Parameters:
+ *      A2Methods_T methods: methods of the arrays of a stage
+ *
+ * Return:
+ *      true when the arrays are plain UArray2s, whose rows the stage may
+ *      walk with ROWLOOP_ROW
+ *
+ * Expects: None
+ *
+ *******************************************************************/
+static inline bool rowloop_plain(A2Methods_T methods)
+{
+        return methods == uarray2_methods_plain;
+}
+
+/**************************rowloop_run********************************
+ *
+ * Parameters:
+ *      A2Methods_T methods: methods of the arrays of a stage
+ *      A2Methods_mapfun *map: the map the stage was given
+ *      unsigned nrows: number of rows to run
+ *      threadpool_rangefun *rows: loop over rows first to last - 1
+ *      void *cl: closure passed to rows
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid methods and rows
+ *
+ * Notes: runs the rows on the shared thread pool when map is the
+ *      parallel map of methods, and on this thread otherwise, just as
+ *      the map would have
+ *
+ *******************************************************************/
+static inline void rowloop_run(A2Methods_T methods, A2Methods_mapfun *map,
+        unsigned nrows, threadpool_rangefun *rows, void *cl)
+{
+        if (map != NULL && map == methods->map_parallel) {
+                threadpool_for(threadpool_shared(), nrows, rows, cl);
+        } else {
+                rows(0, nrows, cl);
+        }
+}
+
+#endif
@@ -0,0 +1,58 @@
+/***********************************************************************
+ * 
+ *                      simd.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements run-time instruction set detection
+ * 
+ ***********************************************************************/
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simd.h"
+
+static simd_level level;
+
+/*finds the level; run exactly once, by pthread_once*/
+static void detect_level(void)
+{
+        simd_level best = SIMD_SCALAR;
+#if SIMD_X86
+        best = SIMD_SSE2;
+        if (__builtin_cpu_supports("avx2")) {
+                best = SIMD_AVX2;
+        }
+#endif
+        const char *cap = getenv("COMP40_SIMD");
+        if (cap != NULL) {
+                if (strcmp(cap, "scalar") == 0) {
+                        best = SIMD_SCALAR;
+                } else if (strcmp(cap, "sse2") == 0 && best > SIMD_SSE2) {
+                        best = SIMD_SSE2;
+                }
+        }
+        level = best;
+}
+
+/**************************simd_detect********************************
+ * 
+ * Parameters: 
+ *      None
+ * 
+ * Return: 
+ *      the best instruction set supported by the running cpu
+ * 
+ * Expects: None
+ * 
+ * Notes: the answer is computed once, and it is safe to call from
+ *      several threads at a time. Setting the environment variable
+ *      COMP40_SIMD to "scalar", "sse2" or "avx2" caps the level
+ * 
+ * *******************************************************************/
+simd_level simd_detect(void)
+{
+        static pthread_once_t once = PTHREAD_ONCE_INIT;
+        pthread_once(&once, detect_level);
+        return level;
+}
@@ -0,0 +1,46 @@
+/***********************************************************************
+ * 
+ *                      simd.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the declaration of the run-time
+ *              instruction set detection used to pick SIMD kernels
+ * 
+ ***********************************************************************/
+#ifndef SIMD_INCLUDED
+#define SIMD_INCLUDED
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+/*instruction sets a kernel can be built for, in increasing order*/
+typedef enum simd_level {
+        SIMD_SCALAR = 0,
+        SIMD_SSE2,
+        SIMD_AVX2
+} simd_level;
+
+/**************************simd_detect********************************
+ * 
+ * Parameters: 
+ *      None
+ * 
+ * Return: 
+ *      the best instruction set supported by the running cpu
+ * 
+ * Expects: None
+ * 
+ * Notes: the answer is computed once. Setting the environment variable
+ *      COMP40_SIMD to "scalar", "sse2" or "avx2" caps the level, which
+ *      lets every kernel be checked against the scalar code on one
+ *      machine
+ * 
+ * *******************************************************************/
+extern simd_level simd_detect(void);
+
+#endif
@@ -0,0 +1,139 @@
+/***********************************************************************
+ *
+ *                      spscring.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements the single producer, single
+ *              consumer ring.
+ *
+ *              The producer owns the tail index and the consumer owns
+ *              the head, so neither is ever written by both threads and
+ *              no lock is taken. Two semaphores count the filled and the
+ *              free slots; a post or a wait that does not have to sleep
+ *              is a single atomic operation, and its ordering publishes
+ *              the slot written before it. A thread sleeps in the kernel
+ *              only when its side of the ring is empty or full.
+ *
+ ***********************************************************************/
+#include <errno.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include "assert.h"
+#include "spscring.h"
+
+struct spsc_ring {
+        unsigned capacity;
+        void **slots;
+        sem_t filled;           /*slots pushed and not yet popped*/
+        sem_t empty;            /*slots the producer may fill*/
+        unsigned tail;          /*next slot to fill, the producer's*/
+        unsigned head;          /*next slot to take, the consumer's*/
+};
+
+/**************************spscring_new********************************
+ *
+ * Parameters:
+ *      unsigned capacity: number of pointers the ring holds
+ *
+ * Return:
+ *      a new, empty ring
+ *
+ * Expects: capacity greater than 0
+ *
+ * Notes: CRE is raised when malloc or semaphore creation fails
+ *
+ * *******************************************************************/
+spsc_ring spscring_new(unsigned capacity)
+{
+        assert(capacity > 0);
+        spsc_ring ring = malloc(sizeof(*ring));
+        assert(ring != NULL);
+        ring->capacity = capacity;
+        ring->slots = malloc(capacity * sizeof(*ring->slots));
+        assert(ring->slots != NULL);
+        ring->tail = 0;
+        ring->head = 0;
+        int failed = sem_init(&ring->filled, 0, 0) ||
+                     sem_init(&ring->empty, 0, capacity);
+        assert(!failed);
+        return ring;
+}
+
+/*sem_wait, retried when a signal interrupts it; any other failure is a
+ CRE*/
+static void wait_for(sem_t *sem)
+{
+        while (sem_wait(sem) != 0) {
+                assert(errno == EINTR);
+        }
+}
+
+/**************************spscring_push********************************
+ *
+ * Parameters:
+ *      spsc_ring ring: a ring
+ *      void *item: pointer to hand to the consumer; may be NULL
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid ring, called by its one producer
+ *
+ * Notes: waits while the ring is full
+ *
+ * *******************************************************************/
+void spscring_push(spsc_ring ring, void *item)
+{
+        assert(ring != NULL);
+        wait_for(&ring->empty);
+        ring->slots[ring->tail] = item;
+        ring->tail = (ring->tail + 1 == ring->capacity) ? 0 : ring->tail + 1;
+        sem_post(&ring->filled);
+}
+
+/**************************spscring_pop********************************
+ *
+ * Parameters:
+ *      spsc_ring ring: a ring
+ *
+ * Return:
+ *      the oldest pointer pushed and not yet popped
+ *
+ * Expects: valid ring, called by its one consumer
+ *
+ * Notes: waits while the ring is empty
+ *
+ * *******************************************************************/
+void *spscring_pop(spsc_ring ring)
+{
+        assert(ring != NULL);
+        wait_for(&ring->filled);
+        void *item = ring->slots[ring->head];
+        ring->head = (ring->head + 1 == ring->capacity) ? 0 : ring->head + 1;
+        sem_post(&ring->empty);
+        return item;
+}
+
+/**************************spscring_free********************************
+ *
+ * Parameters:
+ *      spsc_ring *ring: pointer to the ring to be freed
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid pointer and ring, no thread waiting on it
+ *
+ * Notes: sets *ring to NULL
+ *
+ * *******************************************************************/
+void spscring_free(spsc_ring *ring)
+{
+        assert(ring != NULL && *ring != NULL);
+        sem_destroy(&(*ring)->filled);
+        sem_destroy(&(*ring)->empty);
+        free((*ring)->slots);
+        free(*ring);
+        *ring = NULL;
+}
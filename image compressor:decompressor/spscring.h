@@ -0,0 +1,79 @@
+/***********************************************************************
+ *
+ *                      spscring.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the interface to a ring buffer that
+ *              passes pointers from one producer thread to one consumer
+ *              thread
+ *
+ ***********************************************************************/
+#ifndef SPSCRING_INCLUDED
+#define SPSCRING_INCLUDED
+
+/*a bounded queue of pointers with one producer and one consumer*/
+typedef struct spsc_ring *spsc_ring;
+
+/**************************spscring_new********************************
+ *
+ * Parameters:
+ *      unsigned capacity: number of pointers the ring holds
+ *
+ * Return:
+ *      a new, empty ring
+ *
+ * Expects: capacity greater than 0
+ *
+ * Notes: CRE is raised when malloc or semaphore creation fails
+ *
+ * *******************************************************************/
+extern spsc_ring spscring_new(unsigned capacity);
+
+/**************************spscring_push********************************
+ *
+ * Parameters:
+ *      spsc_ring ring: a ring
+ *      void *item: pointer to hand to the consumer; may be NULL
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid ring, called by its one producer
+ *
+ * Notes: waits while the ring is full
+ *
+ * *******************************************************************/
+extern void spscring_push(spsc_ring ring, void *item);
+
+/**************************spscring_pop********************************
+ *
+ * Parameters:
+ *      spsc_ring ring: a ring
+ *
+ * Return:
+ *      the oldest pointer pushed and not yet popped
+ *
+ * Expects: valid ring, called by its one consumer
+ *
+ * Notes: waits while the ring is empty
+ *
+ * *******************************************************************/
+extern void *spscring_pop(spsc_ring ring);
+
+/**************************spscring_free********************************
+ *
+ * Parameters:
+ *      spsc_ring *ring: pointer to the ring to be freed
+ *
+ * Return:
+ *      None
+ *
+ * Expects: valid pointer and ring, no thread waiting on it
+ *
+ * Notes: sets *ring to NULL
+ *
+ * *******************************************************************/
+extern void spscring_free(spsc_ring *ring);
+
+#endif
@@ -0,0 +1,325 @@
+/***********************************************************************
+ * 
+ *                      threadpool.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements the thread pool.
+ * 
+ *              A batch is published under the mutex by bumping a
+ *              generation number; workers that see a new generation
+ *              take task numbers from a shared counter with an atomic
+ *              add until it runs past the end, and the last one to
+ *              finish wakes the caller. Only one batch runs at a time;
+ *              the caller of any other batch runs it alone, which also
+ *              makes batches started from inside a task safe.
+ * 
+ ***********************************************************************/
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "assert.h"
+#include "threadpool.h"
+
+struct thread_pool {
+        unsigned nthreads;              /*workers + the calling thread*/
+        pthread_t *workers;
+        pthread_mutex_t lock;
+        pthread_cond_t start;           /*a batch was published*/
+        pthread_cond_t done;            /*the last worker left a batch*/
+        pthread_mutex_t running;        /*held while a batch is out*/
+        unsigned long generation;       /*batches published so far*/
+        unsigned busy;                  /*workers still in the batch*/
+        int stop;
+
+        /*the current batch*/
+        threadpool_taskfun *task;
+        void *cl;
+        unsigned ntasks;
+        unsigned next;                  /*next task to hand out*/
+};
+
+/*runs tasks of the current batch until none are left*/
+static void run_tasks(thread_pool pool)
+{
+        for (;;) {
+                unsigned t = __atomic_fetch_add(&pool->next, 1, 
+                        __ATOMIC_RELAXED);
+                if (t >= pool->ntasks) {
+                        return;
+                }
+                pool->task(t, pool->cl);
+        }
+}
+
+static void *worker(void *arg)
+{
+        thread_pool pool = arg;
+        unsigned long seen = 0;
+
+        pthread_mutex_lock(&pool->lock);
+        for (;;) {
+                while (!pool->stop && pool->generation == seen) {
+                        pthread_cond_wait(&pool->start, &pool->lock);
+                }
+                if (pool->stop) {
+                        break;
+                }
+                seen = pool->generation;
+                pthread_mutex_unlock(&pool->lock);
+
+                run_tasks(pool);
+
+                pthread_mutex_lock(&pool->lock);
+                if (--pool->busy == 0) {
+                        pthread_cond_signal(&pool->done);
+                }
+        }
+        pthread_mutex_unlock(&pool->lock);
+        return NULL;
+}
+
+/**************************threadpool_new********************************
+ * 
+ * Parameters:
+ *      unsigned nthreads: number of threads to run tasks on, counting the
+ *              caller; 0 means one per online cpu
+ * 
+ * Return: 
+ *      a new pool with nthreads - 1 worker threads
+ * 
+ * Expects: None
+ * 
+ * Notes: CRE is raised when malloc or thread creation fails
+ * 
+ * *******************************************************************/
+thread_pool threadpool_new(unsigned nthreads)
+{
+        if (nthreads == 0) {
+                long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+                nthreads = (cpus > 0) ? (unsigned) cpus : 1;
+        }
+
+        thread_pool pool = malloc(sizeof(*pool));
+        assert(pool != NULL);
+        pool->nthreads = nthreads;
+        pool->workers = malloc(nthreads * sizeof(*pool->workers));
+        assert(pool->workers != NULL);
+        pthread_mutex_init(&pool->lock, NULL);
+        pthread_mutex_init(&pool->running, NULL);
+        pthread_cond_init(&pool->start, NULL);
+        pthread_cond_init(&pool->done, NULL);
+        pool->generation = 0;
+        pool->busy = 0;
+        pool->stop = 0;
+        pool->task = NULL;
+        pool->cl = NULL;
+        pool->ntasks = 0;
+        pool->next = 0;
+
+        for (unsigned i = 0; i + 1 < nthreads; i++) {
+                int failed = pthread_create(&pool->workers[i], NULL, worker,
+                        pool);
+                assert(failed == 0);
+        }
+        return pool;
+}
+
+/**************************threadpool_size********************************
+ * 
+ * Parameters:
+ *      thread_pool pool: a pool
+ * 
+ * Return: 
+ *      the number of threads that run tasks, counting the caller
+ * 
+ * Expects: valid pool
+ * 
+ * *******************************************************************/
+unsigned threadpool_size(thread_pool pool)
+{
+        assert(pool != NULL);
+        return pool->nthreads;
+}
+
+/**************************threadpool_run********************************
+ * 
+ * Parameters:
+ *      thread_pool pool: a pool
+ *      unsigned ntasks: number of tasks in the batch
+ *      threadpool_taskfun *task: function that runs one task
+ *      void *cl: closure passed to every task
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pool
+ * 
+ * Notes: a pool of one thread, a batch of one task, or a batch that finds
+ *      the pool busy runs on the caller without waking anybody
+ * 
+ * *******************************************************************/
+void threadpool_run(thread_pool pool, unsigned ntasks,
+        threadpool_taskfun *task, void *cl)
+{
+        assert(pool != NULL && task != NULL);
+        if (pool->nthreads == 1 || ntasks <= 1 ||
+            pthread_mutex_trylock(&pool->running) != 0) {
+                for (unsigned t = 0; t < ntasks; t++) {
+                        task(t, cl);
+                }
+                return;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        pool->task = task;
+        pool->cl = cl;
+        pool->ntasks = ntasks;
+        pool->next = 0;
+        pool->busy = pool->nthreads - 1;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->start);
+        pthread_mutex_unlock(&pool->lock);
+
+        run_tasks(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        while (pool->busy > 0) {
+                pthread_cond_wait(&pool->done, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+        pthread_mutex_unlock(&pool->running);
+}
+
+/*ranges per thread in threadpool_for, so uneven ranges balance out*/
+#define RANGES_PER_THREAD 4
+
+/*one call of threadpool_for*/
+struct range_batch {
+        threadpool_rangefun *range;
+        void *cl;
+        unsigned n;
+        unsigned per_task;      /*items in every range but the last*/
+};
+
+static void run_range(unsigned task, void *cl)
+{
+        struct range_batch *batch = cl;
+        unsigned first = task * batch->per_task;
+        unsigned last = (batch->n - first > batch->per_task) ? 
+                first + batch->per_task : batch->n;
+        batch->range(first, last, batch->cl);
+}
+
+/**************************threadpool_for********************************
+ * 
+ * Parameters:
+ *      thread_pool pool: a pool
+ *      unsigned n: number of items
+ *      threadpool_rangefun *range: function that runs a range of items
+ *      void *cl: closure passed to every call
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pool
+ * 
+ * Notes: a pool of one thread gets the whole range in one call
+ * 
+ * *******************************************************************/
+void threadpool_for(thread_pool pool, unsigned n, 
+        threadpool_rangefun *range, void *cl)
+{
+        assert(pool != NULL && range != NULL);
+        if (n == 0) {
+                return;
+        }
+        unsigned ntasks = (pool->nthreads == 1) ? 1 : 
+                pool->nthreads * RANGES_PER_THREAD;
+        struct range_batch batch = { range, cl, n, (n + ntasks - 1) / ntasks };
+        threadpool_run(pool, (n + batch.per_task - 1) / batch.per_task,
+                run_range, &batch);
+}
+
+static thread_pool shared = NULL;
+static unsigned shared_threads = 1;
+
+static void make_shared(void)
+{
+        shared = threadpool_new(shared_threads);
+}
+
+static pthread_once_t shared_once = PTHREAD_ONCE_INIT;
+
+/**************************threadpool_shared********************************
+ * 
+ * Parameters:
+ *      None
+ * 
+ * Return: 
+ *      the pool shared by the whole program, made on the first call
+ * 
+ * Expects: None
+ * 
+ * Notes: the pool lives until the program exits
+ * 
+ * *******************************************************************/
+thread_pool threadpool_shared(void)
+{
+        pthread_once(&shared_once, make_shared);
+        return shared;
+}
+
+/**************************threadpool_shared_size*****************************
+ * 
+ * Parameters:
+ *      unsigned nthreads: threads of the shared pool, as threadpool_new
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: called before the first call to threadpool_shared
+ * 
+ * Notes: CRE if the shared pool has already been made
+ * 
+ * *******************************************************************/
+void threadpool_shared_size(unsigned nthreads)
+{
+        assert(shared == NULL);
+        shared_threads = nthreads;
+}
+
+/**************************threadpool_free********************************
+ * 
+ * Parameters:
+ *      thread_pool *pool: pointer to the pool to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to an idle pool
+ * 
+ * Notes: stops and joins the workers, then sets *pool to NULL
+ * 
+ * *******************************************************************/
+void threadpool_free(thread_pool *pool)
+{
+        assert(pool != NULL && *pool != NULL);
+        thread_pool p = *pool;
+
+        pthread_mutex_lock(&p->lock);
+        p->stop = 1;
+        pthread_cond_broadcast(&p->start);
+        pthread_mutex_unlock(&p->lock);
+        for (unsigned i = 0; i + 1 < p->nthreads; i++) {
+                pthread_join(p->workers[i], NULL);
+        }
+
+        pthread_cond_destroy(&p->start);
+        pthread_cond_destroy(&p->done);
+        pthread_mutex_destroy(&p->lock);
+        pthread_mutex_destroy(&p->running);
+        free(p->workers);
+        free(p);
+        *pool = NULL;
+}
@@ -0,0 +1,145 @@
+/***********************************************************************
+ * 
+ *                      threadpool.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the interface to a pool of worker
+ *              threads that run a batch of independent tasks
+ * 
+ ***********************************************************************/
+#ifndef THREADPOOL_INCLUDED
+#define THREADPOOL_INCLUDED
+
+/*a set of threads that stay alive between batches of tasks*/
+typedef struct thread_pool *thread_pool;
+
+/*runs task number 'task' of a batch; cl is the closure of the batch*/
+typedef void threadpool_taskfun(unsigned task, void *cl);
+
+/**************************threadpool_new********************************
+ * 
+ * Parameters:
+ *      unsigned nthreads: number of threads to run tasks on, counting the
+ *              thread that calls threadpool_run; 0 means one per online
+ *              cpu
+ * 
+ * Return: 
+ *      a new pool with nthreads - 1 worker threads
+ * 
+ * Expects: None
+ * 
+ * Notes: CRE is raised when malloc or thread creation fails
+ * 
+ * *******************************************************************/
+extern thread_pool threadpool_new(unsigned nthreads);
+
+/**************************threadpool_size********************************
+ * 
+ * Parameters:
+ *      thread_pool pool: a pool
+ * 
+ * Return: 
+ *      the number of threads that run tasks, counting the caller
+ * 
+ * Expects: valid pool
+ * 
+ * *******************************************************************/
+extern unsigned threadpool_size(thread_pool pool);
+
+/**************************threadpool_run********************************
+ * 
+ * Parameters:
+ *      thread_pool pool: a pool
+ *      unsigned ntasks: number of tasks in the batch
+ *      threadpool_taskfun *task: function that runs one task
+ *      void *cl: closure passed to every task
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pool
+ * 
+ * Notes: runs task(0, cl) to task(ntasks - 1, cl), each exactly once and
+ *      in no particular order, on the workers and the calling thread,
+ *      and returns when all of them have finished. Tasks are handed out
+ *      one at a time, so uneven tasks balance themselves. A batch started
+ *      while the pool is busy, from a task or from another thread, runs
+ *      all its tasks on the calling thread instead
+ * 
+ * *******************************************************************/
+extern void threadpool_run(thread_pool pool, unsigned ntasks,
+        threadpool_taskfun *task, void *cl);
+
+/*runs the items first to last - 1 of a range; cl is the closure*/
+typedef void threadpool_rangefun(unsigned first, unsigned last, void *cl);
+
+/**************************threadpool_for********************************
+ * 
+ * Parameters:
+ *      thread_pool pool: a pool
+ *      unsigned n: number of items
+ *      threadpool_rangefun *range: function that runs a range of items
+ *      void *cl: closure passed to every call
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pool
+ * 
+ * Notes: splits items 0 to n - 1 into a few contiguous ranges per thread
+ *      and runs them as one batch of threadpool_run. Every item is in
+ *      exactly one range
+ * 
+ * *******************************************************************/
+extern void threadpool_for(thread_pool pool, unsigned n,
+        threadpool_rangefun *range, void *cl);
+
+/**************************threadpool_shared********************************
+ * 
+ * Parameters:
+ *      None
+ * 
+ * Return: 
+ *      the pool shared by the whole program, made on the first call
+ * 
+ * Expects: None
+ * 
+ * Notes: safe to call from any thread. The pool has the number of
+ *      threads given to threadpool_shared_size, 1 by default, in which
+ *      case every batch runs on the calling thread
+ * 
+ * *******************************************************************/
+extern thread_pool threadpool_shared(void);
+
+/**************************threadpool_shared_size*****************************
+ * 
+ * Parameters:
+ *      unsigned nthreads: threads of the shared pool, as threadpool_new
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: called before the first call to threadpool_shared
+ * 
+ * Notes: CRE if the shared pool has already been made
+ * 
+ * *******************************************************************/
+extern void threadpool_shared_size(unsigned nthreads);
+
+/**************************threadpool_free********************************
+ * 
+ * Parameters:
+ *      thread_pool *pool: pointer to the pool to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to an idle pool
+ * 
+ * Notes: stops and joins the workers, then sets *pool to NULL
+ * 
+ * *******************************************************************/
+extern void threadpool_free(thread_pool *pool);
+
+#endif
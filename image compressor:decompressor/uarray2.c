@@ -1,71 +1,97 @@
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "assert.h"
 #include "mem.h"
-#include "uarray.h"
 #include "uarray2.h"
 
 #define T UArray2_T
 
-/* 
- * Element (i, j) in the world of ideas maps to
- * rows[j][i] where the square brackets stand for access
- * to a Hanson UArray_T
+/* alignment of the first cell, one cache line */
+#define ALIGNMENT 64
+
+/*
+ * Element (i, j) in the world of ideas maps to the 'size' bytes at
+ * elems + j * stride + i * size.  The header and the cells come from a
+ * single allocation; 'elems' points into the same block, rounded up to
+ * a cache line boundary
  */
 struct T {
         int width, height;
         int size;
-        UArray_T rows; /* UArray_T of 'height' UArray_Ts,
-                          each of length 'width' and size 'size' */
+        int stride;     /* bytes from the start of one row to the next */
+        int owned;      /* 0 when placed in memory from UArray2_new_in */
+        char *elems;
 };
 
-static inline UArray_T row(T a, int j)
+static int is_ok(T a)
 {
-        UArray_T *prow = UArray_at(a->rows, j);   /* Ramsey idiom */
-        return *prow;
+        return a && a->width >= 0 && a->height >= 0 && a->size > 0 &&
+               a->stride >= a->width * a->size &&
+               ((uintptr_t) a->elems % ALIGNMENT) == 0;
 }
 
-static int is_ok(T a)
+size_t UArray2_bytes(int width, int height, int size)
 {
-        return a && UArray_length(a->rows) == a->height &&
-               UArray_size(a->rows) == sizeof(UArray_T) &&
-               (a->height == 0 || (UArray_length(row(a, 0)) == a->width
-                                   && UArray_size  (row(a, 0)) == a->size));
+        assert(width >= 0 && height >= 0 && size > 0);
+        return sizeof(struct T) + ALIGNMENT + (size_t) width * size * height;
 }
 
-T UArray2_new(int width, int height, int size)
+T UArray2_new_in(void *mem, int width, int height, int size)
 {
-        int i;  /* interates over row number */
-        T array;
-        NEW(array);
+        T array = mem;
+        assert(array != NULL && width >= 0 && height >= 0 && size > 0);
         array->width  = width;
         array->height = height;
         array->size   = size;
-        array->rows   = UArray_new(height, sizeof(UArray_T));
-        for (i = 0; i < height; i++) {
-                UArray_T *rowp = UArray_at(array->rows, i);
-                *rowp = UArray_new(width, size);
-        }
+        array->stride = (long) width * size;
+        array->owned  = 0;
+        array->elems  = (char *) (((uintptr_t) (array + 1) + ALIGNMENT - 1) &
+                                  ~(uintptr_t) (ALIGNMENT - 1));
         assert(is_ok(array));
         return array;
 }
 
+T UArray2_new(int width, int height, int size)
+{
+        T array = UArray2_new_in(CALLOC(1, UArray2_bytes(width, height, size)),
+                                 width, height, size);
+        array->owned = 1;
+        return array;
+}
+
 void UArray2_free(T *array2)
 {
-        int i;
         assert(array2 != NULL && *array2 != NULL);
-        for (i = 0; i < (*array2)->height; i++) {
-                UArray_T p = row(*array2, i);
-                UArray_free(&p);
-        }
-        UArray_free(&(*array2)->rows);
-        FREE(*array2);
+        if ((*array2)->owned)
+                FREE(*array2);
+        *array2 = NULL;
+}
+
+void UArray2_trim(T array2, int width, int height)
+{
+        assert(array2 != NULL);
+        assert(width >= 0 && width <= array2->width);
+        assert(height >= 0 && height <= array2->height);
+        /* the stride stays, so each cell keeps its address */
+        array2->width  = width;
+        array2->height = height;
 }
 
 void *UArray2_at(T array2, int i, int j)
 {
         assert(array2 != NULL);
-        return UArray_at(row(array2, j), i);
+        assert(i >= 0 && i < array2->width && j >= 0 && j < array2->height);
+        return array2->elems + (long) j * array2->stride +
+               (long) i * array2->size;
+}
+
+void *UArray2_row(T array2, int j)
+{
+        assert(array2 != NULL);
+        assert(j >= 0 && j < array2->height);
+        return array2->elems + (long) j * array2->stride;
 }
 
 int UArray2_height(T array2)
@@ -86,31 +112,73 @@ int UArray2_size(T array2)
         return array2->size;
 }
 
-void UArray2_map_row_major(T array2, 
-                           void apply(int i, int j, T array2, 
-                                      void *elem, void *cl), 
+int UArray2_stride(T array2)
+{
+        assert(array2 != NULL);
+        return array2->stride;
+}
+
+void UArray2_map_row_major(T array2,
+                           void apply(int i, int j, T array2,
+                                      void *elem, void *cl),
                            void *cl)
 {
         assert(array2!= NULL);
-        int h = array2->height;  /* keeping height and width in registers */
-        int w = array2->width;   /* avoids extra memory traffic           */
-        for (int j = 0; j < h; j++) {
-                /* don't want row/UArray_at in inner loop */
-                UArray_T thisrow = row(array2, j); 
-                for (int i = 0; i < w; i++)
-                        apply(i, j, array2, UArray_at(thisrow, i), cl);
+        UArray2_map_rows(array2, 0, array2->height, apply, cl);
+}
+
+void UArray2_map_rows(T array2, int first, int last,
+                      void apply(int i, int j, T array2,
+                                 void *elem, void *cl),
+                      void *cl)
+{
+        assert(array2 != NULL);
+        assert(0 <= first && first <= last && last <= array2->height);
+        int w = array2->width;   /* keeping width and size in registers */
+        int size = array2->size; /* avoids extra memory traffic          */
+        for (int j = first; j < last; j++) {
+                /* walk the row with a pointer, no multiply per cell */
+                char *elem = array2->elems + (long) j * array2->stride;
+                for (int i = 0; i < w; i++, elem += size)
+                        apply(i, j, array2, elem, cl);
         }
 }
 
-void UArray2_map_col_major(T array2, 
-                           void apply(int i, int j, T array2, 
-                                      void *elem, void *cl), 
+void UArray2_map_2x2(T array2, int first, int last,
+                     void apply(int i, int j, T array2,
+                                void *cells[4], void *cl),
+                     void *cl)
+{
+        assert(array2 != NULL);
+        assert(0 <= first && first <= last && last <= array2->height / 2);
+        int blocks = array2->width / 2;
+        int size = array2->size;
+        for (int j = first; j < last; j++) {
+                /* the two rows of a block row are one stride apart */
+                char *top = array2->elems + (long) (2 * j) * array2->stride;
+                char *bottom = top + array2->stride;
+                for (int i = 0; i < blocks; i++) {
+                        void *cells[4] = { top, top + size, 
+                                           bottom, bottom + size };
+                        apply(i, j, array2, cells, cl);
+                        top += 2 * size;
+                        bottom += 2 * size;
+                }
+        }
+}
+
+void UArray2_map_col_major(T array2,
+                           void apply(int i, int j, T array2,
+                                      void *elem, void *cl),
                            void *cl)
 {
         assert(array2 != NULL);
         int h = array2->height;  /* keeping height and width in registers */
         int w = array2->width;   /* avoids extra memory traffic           */
-        for (int i = 0; i < w; i++)
-                for (int j = 0; j < h; j++)
-                        apply(i, j, array2, UArray_at(row(array2, j), i), cl);
-}
\ No newline at end of file
+        long stride = array2->stride;
+        for (int i = 0; i < w; i++) {
+                char *elem = array2->elems + (long) i * array2->size;
+                for (int j = 0; j < h; j++, elem += stride)
+                        apply(i, j, array2, elem, cl);
+        }
+}
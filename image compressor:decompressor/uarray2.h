@@ -1,18 +1,51 @@
 #ifndef ARRAY2_INCLUDED
 #define ARRAY2_INCLUDED
+#include <stddef.h>
 #define T UArray2_T
 typedef struct T *T;
 
 typedef void UArray2_applyfun(int i, int j, T array2, void *elem, void *cl);
 typedef void UArray2_mapfun(T array2, UArray2_applyfun apply, void *cl);
+/* cells holds cells (2i, 2j), (2i + 1, 2j), (2i, 2j + 1), (2i + 1, 2j + 1) */
+typedef void UArray2_apply2x2fun(int i, int j, T array2, void *cells[4],
+                                 void *cl);
 
 extern T     UArray2_new   (int width, int height, int size);
+/* bytes UArray2_new_in needs for such an array */
+extern size_t UArray2_bytes(int width, int height, int size);
+/* makes an array of uninitialized cells in the given UArray2_bytes of
+ * memory, which the caller owns; UArray2_free does not release it
+ */
+extern T     UArray2_new_in(void *mem, int width, int height, int size);
 extern void  UArray2_free  (T *array2);
 extern int   UArray2_width (T array2);
 extern int   UArray2_height(T array2);
 extern int   UArray2_size  (T array2);
+/* bytes between the starts of consecutive rows; rows are contiguous */
+extern int   UArray2_stride(T array2);
+/* shrinks the array in place to its top-left width x height cells; the
+ * cells are not moved and the memory is not released.  It is a CRE to
+ * grow the array
+ */
+extern void  UArray2_trim  (T array2, int width, int height);
 extern void *UArray2_at    (T array2, int i, int j);
+/* address of cell (0, j); cell (i, j) is i * size bytes past it, so a
+ * loop can walk a row with a typed pointer instead of calling at
+ */
+extern void *UArray2_row   (T array2, int j);
 extern void  UArray2_map_row_major(T array2, UArray2_applyfun apply, void *cl);
 extern void  UArray2_map_col_major(T array2, UArray2_applyfun apply, void *cl);
+/* visits rows first to last - 1 in row-major order; it is a CRE for the
+ * rows to be outside the array
+ */
+extern void  UArray2_map_rows(T array2, int first, int last,
+                              UArray2_applyfun apply, void *cl);
+/* visits the 2x2 blocks whose top rows are 2 * first to 2 * last - 2,
+ * walking both rows of a block row together; a trailing odd row or
+ * column is not visited.  It is a CRE for the rows to be outside the
+ * array
+ */
+extern void  UArray2_map_2x2(T array2, int first, int last,
+                             UArray2_apply2x2fun apply, void *cl);
 #undef T
 #endif
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "uarray2b.h"
+
+#define T UArray2b_T
+
+/* alignment of the first block, one cache line */
+#define ALIGNMENT 64
+
+/*
+ * Cells are stored block by block in one allocation, blocks in row-major
+ * order and cells row-major within a block.  Element (i, j) lives in
+ * block (i / blocksize, j / blocksize) at cell (i % blocksize,
+ * j % blocksize) of that block.  Blocks on the right and bottom edges are
+ * allocated whole even when part of them is outside the array.
+ *
+ * A block that fits in a cache line is padded to a power of two bytes,
+ * so with an aligned buffer no block straddles two cache lines
+ */
+struct T {
+        int width, height;
+        int size;
+        int blocksize;
+        int shift;              /* log2(blocksize), or -1 if not a power
+                                   of two; saves two divisions per at */
+        int blocks_wide;        /* blocks per row of blocks */
+        int blocks_high;
+        long blockbytes;        /* bytes from one block to the next */
+        int owned;              /* 0 when placed by UArray2b_new_in */
+        char *elems;
+};
+
+static int is_ok(T a)
+{
+        return a && a->width >= 0 && a->height >= 0 && a->size > 0 &&
+               a->blocksize > 0 &&
+               a->blockbytes >= (long) a->blocksize * a->blocksize * a->size &&
+               ((uintptr_t) a->elems % ALIGNMENT) == 0;
+}
+
+/* bytes from the start of one block to the next */
+static long block_bytes(int size, int blocksize)
+{
+        long blockbytes = (long) blocksize * blocksize * size;
+        if (blockbytes <= ALIGNMENT) {
+                long padded = 1;
+                while (padded < blockbytes)
+                        padded *= 2;
+                blockbytes = padded;
+        }
+        return blockbytes;
+}
+
+size_t UArray2b_bytes(int width, int height, int size, int blocksize)
+{
+        assert(width >= 0 && height >= 0 && size > 0 && blocksize >= 1);
+        long blocks_wide = (width + blocksize - 1) / blocksize;
+        long blocks_high = (height + blocksize - 1) / blocksize;
+        return sizeof(struct T) + ALIGNMENT +
+               (size_t) (block_bytes(size, blocksize) * blocks_wide *
+                         blocks_high);
+}
+
+T UArray2b_new(int width, int height, int size, int blocksize)
+{
+        void *mem = CALLOC(1, UArray2b_bytes(width, height, size, blocksize));
+        T array = UArray2b_new_in(mem, width, height, size, blocksize);
+        array->owned = 1;
+        return array;
+}
+
+T UArray2b_new_in(void *mem, int width, int height, int size, int blocksize)
+{
+        T array = mem;
+        assert(array != NULL);
+        assert(width >= 0 && height >= 0 && size > 0 && blocksize >= 1);
+
+        long blockbytes = block_bytes(size, blocksize);
+        int blocks_wide = (width + blocksize - 1) / blocksize;
+        int blocks_high = (height + blocksize - 1) / blocksize;
+
+        array->width       = width;
+        array->height      = height;
+        array->size        = size;
+        array->blocksize   = blocksize;
+        array->shift       = -1;
+        for (int k = 0; k < 31; k++)
+                if (blocksize == 1 << k)
+                        array->shift = k;
+        array->blocks_wide = blocks_wide;
+        array->blocks_high = blocks_high;
+        array->blockbytes  = blockbytes;
+        array->owned       = 0;
+        array->elems = (char *) (((uintptr_t) (array + 1) + ALIGNMENT - 1) &
+                                 ~(uintptr_t) (ALIGNMENT - 1));
+        assert(is_ok(array));
+        return array;
+}
+
+T UArray2b_new_64K_block(int width, int height, int size)
+{
+        assert(size > 0);
+        int blocksize = 1;
+        while ((long) (blocksize + 1) * (blocksize + 1) * size <= 64 * 1024)
+                blocksize++;
+        return UArray2b_new(width, height, size, blocksize);
+}
+
+void UArray2b_free(T *array2b)
+{
+        assert(array2b != NULL && *array2b != NULL);
+        if ((*array2b)->owned)
+                FREE(*array2b);
+        *array2b = NULL;
+}
+
+int UArray2b_width(T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->width;
+}
+
+int UArray2b_height(T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->height;
+}
+
+int UArray2b_size(T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->size;
+}
+
+int UArray2b_blocksize(T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->blocksize;
+}
+
+void UArray2b_trim(T array2b, int width, int height)
+{
+        assert(array2b != NULL);
+        assert(width >= 0 && width <= array2b->width);
+        assert(height >= 0 && height <= array2b->height);
+        /* blocks_wide and blocks_high stay, so each cell keeps its
+         * block; map skips the blocks that now lie outside */
+        array2b->width  = width;
+        array2b->height = height;
+}
+
+void *UArray2b_at(T array2b, int column, int row)
+{
+        assert(array2b != NULL);
+        assert(column >= 0 && column < array2b->width &&
+               row >= 0 && row < array2b->height);
+        int bs = array2b->blocksize;
+        long block;
+        int cell;
+        if (array2b->shift >= 0) {
+                int k = array2b->shift;
+                block = (long) (row >> k) * array2b->blocks_wide +
+                        (column >> k);
+                cell = ((row & (bs - 1)) << k) + (column & (bs - 1));
+        } else {
+                block = (long) (row / bs) * array2b->blocks_wide + column / bs;
+                cell = (row % bs) * bs + column % bs;
+        }
+        return array2b->elems + block * array2b->blockbytes +
+               (long) cell * array2b->size;
+}
+
+void UArray2b_map(T array2b, UArray2b_applyfun apply, void *cl)
+{
+        assert(array2b != NULL);
+        UArray2b_map_block_rows(array2b, 0, UArray2b_block_rows(array2b),
+                                apply, cl);
+}
+
+int UArray2b_block_rows(T array2b)
+{
+        assert(array2b != NULL);
+        /* not blocks_high, which still counts rows lost to a trim */
+        return (array2b->height + array2b->blocksize - 1) /
+               array2b->blocksize;
+}
+
+void UArray2b_map_block_rows(T array2b, int first, int last,
+                             UArray2b_applyfun apply, void *cl)
+{
+        assert(array2b != NULL);
+        assert(0 <= first && first <= last &&
+               last <= UArray2b_block_rows(array2b));
+        int bs = array2b->blocksize;
+        int w = array2b->width;
+        int h = array2b->height;
+        int size = array2b->size;
+        int blocks_wide = (w + bs - 1) / bs;
+        for (int bj = first; bj < last; bj++) {
+                char *block = array2b->elems + (long) bj *
+                        array2b->blocks_wide * array2b->blockbytes;
+                for (int bi = 0; bi < blocks_wide; bi++) {
+                        /* clip the edge blocks to the array */
+                        int i0 = bi * bs, j0 = bj * bs;
+                        int iend = i0 + bs < w ? i0 + bs : w;
+                        int jend = j0 + bs < h ? j0 + bs : h;
+                        for (int j = j0; j < jend; j++) {
+                                char *elem = block +
+                                        (long) ((j - j0) * bs) * size;
+                                for (int i = i0; i < iend; i++, elem += size)
+                                        apply(i, j, array2b, elem, cl);
+                        }
+                        block += array2b->blockbytes;
+                }
+        }
+}
+
+void UArray2b_map_2x2(T array2b, int first, int last,
+                      UArray2b_apply2x2fun apply, void *cl)
+{
+        assert(array2b != NULL);
+        assert(0 <= first && first <= last &&
+               last <= UArray2b_block_rows(array2b));
+        int bs = array2b->blocksize;
+        int size = array2b->size;
+        /* the cells that belong to some 2x2 block */
+        int w = array2b->width & ~1;
+        int h = array2b->height & ~1;
+        int blocks_wide = (w + bs - 1) / bs;
+        for (int bj = first; bj < last; bj++) {
+                int j0 = bj * bs;
+                int jend = j0 + bs < h ? j0 + bs : h;
+                if (bs % 2 != 0) {
+                        /* 2x2 blocks start on even rows and may reach
+                         * into the next row or column of blocks */
+                        for (int j = (j0 + 1) & ~1; j < jend; j += 2)
+                                for (int i = 0; i < w; i += 2) {
+                                        void *cells[4] = {
+                                                UArray2b_at(array2b, i, j),
+                                                UArray2b_at(array2b, i + 1, j),
+                                                UArray2b_at(array2b, i, j + 1),
+                                                UArray2b_at(array2b, i + 1,
+                                                            j + 1)
+                                        };
+                                        apply(i / 2, j / 2, array2b, cells,
+                                              cl);
+                                }
+                        continue;
+                }
+                char *block = array2b->elems + (long) bj *
+                        array2b->blocks_wide * array2b->blockbytes;
+                for (int bi = 0; bi < blocks_wide; bi++) {
+                        /* an even blocksize holds whole 2x2 blocks */
+                        int i0 = bi * bs;
+                        int iend = i0 + bs < w ? i0 + bs : w;
+                        for (int j = j0; j < jend; j += 2) {
+                                char *top = block +
+                                        (long) ((j - j0) * bs) * size;
+                                char *bottom = top + (long) bs * size;
+                                for (int i = i0; i < iend; i += 2) {
+                                        void *cells[4] = {
+                                                top, top + size,
+                                                bottom, bottom + size
+                                        };
+                                        apply(i / 2, j / 2, array2b, cells,
+                                              cl);
+                                        top += 2 * size;
+                                        bottom += 2 * size;
+                                }
+                        }
+                        block += array2b->blockbytes;
+                }
+        }
+}
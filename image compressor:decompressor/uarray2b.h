@@ -0,0 +1,59 @@
+#ifndef UARRAY2B_INCLUDED
+#define UARRAY2B_INCLUDED
+#include <stddef.h>
+#define T UArray2b_T
+typedef struct T *T;
+
+typedef void UArray2b_applyfun(int i, int j, T array2b, void *elem, void *cl);
+/* cells holds cells (2i, 2j), (2i + 1, 2j), (2i, 2j + 1), (2i + 1, 2j + 1) */
+typedef void UArray2b_apply2x2fun(int i, int j, T array2b, void *cells[4],
+                                  void *cl);
+
+/* new blocked 2d array: blocksize = square root of # of cells in block.
+ * It is a CRE for blocksize < 1
+ */
+extern T     UArray2b_new (int width, int height, int size, int blocksize);
+/* bytes UArray2b_new_in needs for such an array */
+extern size_t UArray2b_bytes(int width, int height, int size, int blocksize);
+/* makes an array of uninitialized cells in the given UArray2b_bytes of
+ * memory, which the caller owns; UArray2b_free does not release it
+ */
+extern T     UArray2b_new_in(void *mem, int width, int height, int size,
+                             int blocksize);
+/* new blocked 2d array: blocksize as large as possible provided
+ * block occupies at most 64KB (if possible)
+ */
+extern T     UArray2b_new_64K_block(int width, int height, int size);
+extern void  UArray2b_free     (T *array2b);
+extern int   UArray2b_width    (T array2b);
+extern int   UArray2b_height   (T array2b);
+extern int   UArray2b_size     (T array2b);
+extern int   UArray2b_blocksize(T array2b);
+/* shrinks the array in place to its top-left width x height cells; the
+ * blocks are not moved and the memory is not released.  It is a CRE to
+ * grow the array
+ */
+extern void  UArray2b_trim     (T array2b, int width, int height);
+/* return a pointer to the cell in the given column and row.
+ * index out of range is a checked run-time error
+ */
+extern void *UArray2b_at(T array2b, int column, int row);
+/* visits every cell in one block before moving to another block */
+extern void  UArray2b_map(T array2b, UArray2b_applyfun apply, void *cl);
+/* number of rows of blocks that hold cells of the array */
+extern int   UArray2b_block_rows(T array2b);
+/* same as UArray2b_map, but only visits the blocks in rows of blocks
+ * first to last - 1; it is a CRE for them to be outside the array
+ */
+extern void  UArray2b_map_block_rows(T array2b, int first, int last,
+                                     UArray2b_applyfun apply, void *cl);
+/* visits once each 2x2 block of cells whose top-left cell is in rows
+ * of blocks first to last - 1, a block of the array at a time; a
+ * trailing odd row or column is not visited.  With an odd blocksize a
+ * 2x2 block may straddle blocks of the array, and its cells are found
+ * with UArray2b_at
+ */
+extern void  UArray2b_map_2x2(T array2b, int first, int last,
+                              UArray2b_apply2x2fun apply, void *cl);
+#undef T
+#endif
@@ -9,185 +9,328 @@
  * 
  ***********************************************************************/
 #include "videocs_to_word.h"
+#include "bitpackrow.h"
+#include "blockdct.h"
+#include "chroma40.h"
+#include "codec40.h"
+#include "rowloop.h"
+
+/*blocks handled per pass by the row loops; their buffers fit in L1*/
+#define CHUNK 128
+
+/*the closure of the row loops: the pixel planes, the word planes and the
+ code words of the stage*/
+typedef struct plane_rows {
+        vcs_planes pixels;
+        word_planes words;
+        A2Methods_UArray2 coded;
+} plane_rows;
+
+/*the rows j of the word planes, as typed pointers*/
+typedef struct word_row {
+        uint16_t *a;
+        int8_t *b, *c, *d;
+        uint8_t *av_pb, *av_pr;
+} word_row;
+
+static word_row word_row_at(word_planes words, unsigned j)
+{
+        word_row row;
+        row.a = ROWLOOP_ROW(words.a, j, uint16_t);
+        row.b = ROWLOOP_ROW(words.b, j, int8_t);
+        row.c = ROWLOOP_ROW(words.c, j, int8_t);
+        row.d = ROWLOOP_ROW(words.d, j, int8_t);
+        row.av_pb = ROWLOOP_ROW(words.av_pb, j, uint8_t);
+        row.av_pr = ROWLOOP_ROW(words.av_pr, j, uint8_t);
+        return row;
+}
 
-/**************************bcd_range********************************
- * 
- * Parameters:
- *      float val: a float to be checked if in the range [-0.3, 0.3]
- * 
- * Return: 
- *      a float in the specified range for b, c, d values
- * 
- * Expects: valid float
- * 
- * Notes: bcd_range checks if the float is in the specified range. If so,
- *      the value is returned otherwise, -0.3 or 0.3 is returned depending
- *      on which is close
- * 
- * *******************************************************************/
-static float bcd_range(float val) {
-        if (val > 0.3) {
-                return 0.3;
-        } else if (val < -0.3) {
-                return -0.3;
+/*vcs_to_word on plain arrays: block rows first to last - 1. The two
+ pixel rows of every plane are read with unit stride by blockdct_forward
+ and chroma_index_row, CHUNK blocks at a time, and the fields are then
+ narrowed into the word planes*/
+static void vcs_word_rows(unsigned first, unsigned last, void *cl)
+{
+        plane_rows *rows = cl;
+        unsigned width = (unsigned) UArray2_width((UArray2_T) rows->words.a);
+        int32_t a[CHUNK], b[CHUNK], c[CHUNK], d[CHUNK];
+        float avpb[CHUNK], avpr[CHUNK];
+        uint32_t pbindex[CHUNK], prindex[CHUNK];
+        dct_row out = { a, b, c, d, avpb, avpr };
+
+        for (unsigned j = first; j < last; j++) {
+                vcs_rows in = { 
+                        { ROWLOOP_ROW(rows->pixels.y, 2 * j, float),
+                          ROWLOOP_ROW(rows->pixels.y, 2 * j + 1, float) },
+                        { ROWLOOP_ROW(rows->pixels.pb, 2 * j, float),
+                          ROWLOOP_ROW(rows->pixels.pb, 2 * j + 1, float) },
+                        { ROWLOOP_ROW(rows->pixels.pr, 2 * j, float),
+                          ROWLOOP_ROW(rows->pixels.pr, 2 * j + 1, float) }
+                };
+                word_row word = word_row_at(rows->words, j);
+
+                for (unsigned c0 = 0; c0 < width; c0 += CHUNK) {
+                        unsigned n = (width - c0 < CHUNK) ? width - c0 
+                                                          : CHUNK;
+                        blockdct_forward(in, n, out);
+                        chroma_index_row(avpb, n, pbindex);
+                        chroma_index_row(avpr, n, prindex);
+                        for (unsigned k = 0; k < n; k++) {
+                                word.a[c0 + k] = (uint16_t) a[k];
+                                word.b[c0 + k] = (int8_t) b[k];
+                                word.c[c0 + k] = (int8_t) c[k];
+                                word.d[c0 + k] = (int8_t) d[k];
+                                word.av_pb[c0 + k] = (uint8_t) pbindex[k];
+                                word.av_pr[c0 + k] = (uint8_t) prindex[k];
+                        }
+                        for (int r = 0; r < 2; r++) {
+                                in.y[r] += 2 * CHUNK;
+                                in.pb[r] += 2 * CHUNK;
+                                in.pr[r] += 2 * CHUNK;
+                        }
+                }
         }
-        return val;
 }
 
-/**************************a_range********************************
- * 
- * Parameters:
- *      float val: a float to be checked if in the range [0.0, 1.0]
- * 
- * Return: 
- *      a float in the specified range for a values
- * 
- * Expects: valid float
- * 
- * Notes: a_range checks if the float is in the specified range. If so,
- *      the value is returned otherwise, 0.0 or 1.0 is returned depending
- *      on which is close
- * 
- * *******************************************************************/
-static float a_range(float val) {
-        if (val > 1) {
-                return 1.0;
-        } else if (val < 0) {
-                return 0.0;
+/*word_to_vcs on plain arrays: block rows first to last - 1, each written
+ to two rows of every plane*/
+static void word_vcs_rows(unsigned first, unsigned last, void *cl)
+{
+        plane_rows *rows = cl;
+        int width = UArray2_width((UArray2_T) rows->words.a);
+        for (unsigned j = first; j < last; j++) {
+                word_row word = word_row_at(rows->words, j);
+                float *y[2], *pb[2], *pr[2];
+                for (unsigned r = 0; r < 2; r++) {
+                        y[r] = ROWLOOP_ROW(rows->pixels.y, 2 * j + r, float);
+                        pb[r] = ROWLOOP_ROW(rows->pixels.pb, 2 * j + r, 
+                                float);
+                        pr[r] = ROWLOOP_ROW(rows->pixels.pr, 2 * j + r, 
+                                float);
+                }
+                for (int i = 0; i < width; i++) {
+                        struct bitword bit = { word.a[i], word.b[i], 
+                                word.c[i], word.d[i], word.av_pb[i], 
+                                word.av_pr[i] };
+                        struct color_space cs[4];
+                        bitword_to_block(&bit, &cs[0], &cs[1], &cs[2], 
+                                &cs[3]);
+                        for (int k = 0; k < 4; k++) {
+                                int r = k / 2, col = 2 * i + k % 2;
+                                y[r][col] = cs[k].y;
+                                pb[r][col] = cs[k].pb;
+                                pr[r][col] = cs[k].pr;
+                        }
+                }
         }
-        return val;
 }
 
-/**************************a_float_to_int********************************
- * 
- * Parameters:
- *      float val: a float to be converted to uint64_t
- * 
- * Return: 
- *      a uint64_t value of float val
- * 
- * Expects: valid float
- * 
- * Notes: a_float_to_int converts a float value of a to uint64_t by
- *       multiplying it with a floating-point literal 511.0.We chose
- *      511 because it is the maximum value of a in bits for a width of  9
- * 
- * *******************************************************************/
-static uint64_t a_float_to_int(float val) {
-        return (uint64_t)(val * 511.0);
+/*the 2x2 block map of methods to use in place of map: the parallel one
+ when map is parallel, or NULL when methods have none*/
+static A2Methods_blockmapfun *block_map(A2Methods_T methods, 
+        A2Methods_mapfun *map)
+{
+        if (map != NULL && map == methods->map_parallel) {
+                return methods->map_2x2_blocks_parallel;
+        }
+        return methods->map_2x2_blocks;
 }
 
-/**************************a_int_to_float********************************
- * 
- * Parameters:
- *      uint64_t val: a uint64_t val to be converted to a float
- * 
- * Return: 
- *      a uint64_t value of float val
- * 
- * Expects: valid uint64_t
- * 
- * Notes: a_float_to_int converts uint64_t to a float by
- *       dividing it with a floating-point literal 511.0. We chose
- *      511 because it is the maximum value of a in bits for a width of  9
- * 
- * *******************************************************************/
-static float a_int_to_float(uint64_t val) {
-        return ((float) val) / ((float) 511.0);
+/*vcs_to_word for other methods: the four lumas of a block come from
+ map_2x2_blocks over the y plane, its chromas from the other planes, and
+ its word is cell (i, j) of the word planes*/
+static void vcs_block_word(int i, int j, A2Methods_UArray2 arr, 
+        void *cells[4], void *cl)
+{
+        (void) arr;
+        bit_cl m_bitcl = cl;
+        A2Methods_T methods = m_bitcl->methods;
+        struct color_space cs[4];
+        struct bitword bit;
+
+        for (int k = 0; k < 4; k++) {
+                int col = 2 * i + k % 2, row = 2 * j + k / 2;
+                cs[k].y = *(float *) cells[k];
+                cs[k].pb = *(float *) methods->at(m_bitcl->pixels.pb, col, 
+                        row);
+                cs[k].pr = *(float *) methods->at(m_bitcl->pixels.pr, col, 
+                        row);
+        }
+        block_to_bitword(&cs[0], &cs[1], &cs[2], &cs[3], &bit);
+        word_planes_put(methods, m_bitcl->words, i, j, &bit);
 }
 
-/**************************bcd_float_to_int********************************
- * 
- * Parameters:
- *      float val: a float to be converted to int64_t
- * 
- * Return: 
- *      a int64_t value of float val
- * 
- * Expects: valid float
- * 
- * Notes: bcd_float_to_int converts a float value of a to int64_t by
- *       multiplying it with a floating-point literal 31.0. We chose
- *      31 because it is the maximum value of b, c, d in bits for a width of 5.
- *      Before conversion b, c, d values are put in the range [-0.3, 0.3]
- * 
- * *******************************************************************/
-static int64_t bcd_float_to_int(float val) {
-        val = bcd_range(val);
-        return (int64_t)(val * 31.0);
+/*word_to_vcs for other methods: the four lumas of a block go to
+ map_2x2_blocks over the y plane and its chromas to the other planes*/
+static void word_vcs_block(int i, int j, A2Methods_UArray2 arr, 
+        void *cells[4], void *cl)
+{
+        (void) arr;
+        bit_cl m_cl = cl;
+        A2Methods_T methods = m_cl->methods;
+        struct color_space cs[4];
+        struct bitword bt;
+
+        word_planes_get(methods, m_cl->words, i, j, &bt);
+        bitword_to_block(&bt, &cs[0], &cs[1], &cs[2], &cs[3]);
+        for (int k = 0; k < 4; k++) {
+                int col = 2 * i + k % 2, row = 2 * j + k / 2;
+                *(float *) cells[k] = cs[k].y;
+                *(float *) methods->at(m_cl->pixels.pb, col, row) = cs[k].pb;
+                *(float *) methods->at(m_cl->pixels.pr, col, row) = cs[k].pr;
+        }
 }
 
-/**************************bcd_int_to_float********************************
- * 
- * Parameters:
- *      int64_t val: a int64_t val to be converted to a float
- * 
- * Return: 
- *      a uint64_t value of float val
- * 
- * Expects: valid uint64_t
- * 
- * Notes: bcd_int_to_float converts int64_t to a float by
- *       dividing it with a floating-point literal 31.0. We chose
- *      31 because it is the maximum value of b, c, d in bits for a width of 5.
- * 
- * *******************************************************************/
-static float bcd_int_to_float(int64_t val) {
-        return ((float) val) / ((float)31.0);
+/*word_to_codedword on plain arrays: rows first to last - 1, widened
+ CHUNK words at a time for bitpackrow_pack, which packs them straight
+ into the row of code words*/
+static void pack_rows(unsigned first, unsigned last, void *cl)
+{
+        plane_rows *rows = cl;
+        unsigned width = (unsigned) UArray2_width((UArray2_T) rows->coded);
+        int32_t field[CODEWORD_NFIELDS][CHUNK];
+        const int32_t *fields[CODEWORD_NFIELDS];
+
+        for (int f = 0; f < CODEWORD_NFIELDS; f++)
+                fields[f] = field[f];
+
+        for (unsigned j = first; j < last; j++) {
+                word_row word = word_row_at(rows->words, j);
+                uint32_t *code = ROWLOOP_ROW(rows->coded, j, uint32_t);
+
+                for (unsigned c0 = 0; c0 < width; c0 += CHUNK) {
+                        unsigned n = (width - c0 < CHUNK) ? width - c0 
+                                                          : CHUNK;
+                        for (unsigned k = 0; k < n; k++) {
+                                field[CODEWORD_a][k] = word.a[c0 + k];
+                                field[CODEWORD_b][k] = word.b[c0 + k];
+                                field[CODEWORD_c][k] = word.c[c0 + k];
+                                field[CODEWORD_d][k] = word.d[c0 + k];
+                                field[CODEWORD_av_pb][k] = word.av_pb[c0 + k];
+                                field[CODEWORD_av_pr][k] = word.av_pr[c0 + k];
+                        }
+                        bitpackrow_pack(codeword_layout, CODEWORD_NFIELDS, 
+                                fields, n, &code[c0]);
+                }
+        }
+}
+
+/*codedword_to_word on plain arrays: rows first to last - 1, unpacked
+ straight from the row of code words CHUNK words at a time by
+ bitpackrow_unpack and narrowed*/
+static void unpack_rows(unsigned first, unsigned last, void *cl)
+{
+        plane_rows *rows = cl;
+        unsigned width = (unsigned) UArray2_width((UArray2_T) rows->coded);
+        int32_t field[CODEWORD_NFIELDS][CHUNK];
+        int32_t *fields[CODEWORD_NFIELDS];
+
+        for (int f = 0; f < CODEWORD_NFIELDS; f++)
+                fields[f] = field[f];
+
+        for (unsigned j = first; j < last; j++) {
+                const uint32_t *code = ROWLOOP_ROW(rows->coded, j, uint32_t);
+                word_row word = word_row_at(rows->words, j);
+
+                for (unsigned c0 = 0; c0 < width; c0 += CHUNK) {
+                        unsigned n = (width - c0 < CHUNK) ? width - c0 
+                                                          : CHUNK;
+                        bitpackrow_unpack(codeword_layout, CODEWORD_NFIELDS, 
+                                &code[c0], n, fields);
+                        for (unsigned k = 0; k < n; k++) {
+                                word.a[c0 + k] = 
+                                        (uint16_t) field[CODEWORD_a][k];
+                                word.b[c0 + k] = (int8_t) field[CODEWORD_b][k];
+                                word.c[c0 + k] = (int8_t) field[CODEWORD_c][k];
+                                word.d[c0 + k] = (int8_t) field[CODEWORD_d][k];
+                                word.av_pb[c0 + k] = 
+                                        (uint8_t) field[CODEWORD_av_pb][k];
+                                word.av_pr[c0 + k] = 
+                                        (uint8_t) field[CODEWORD_av_pr][k];
+                        }
+                }
+        }
+}
+
+/*six new word planes, width by height blocks, from mem*/
+static word_planes new_word_planes(arena mem, A2Methods_T methods, 
+        int width, int height)
+{
+        word_planes words;
+        words.a = arena_array(mem, methods, width, height, sizeof(uint16_t));
+        words.b = arena_array(mem, methods, width, height, sizeof(int8_t));
+        words.c = arena_array(mem, methods, width, height, sizeof(int8_t));
+        words.d = arena_array(mem, methods, width, height, sizeof(int8_t));
+        words.av_pb = arena_array(mem, methods, width, height, 
+                sizeof(uint8_t));
+        words.av_pr = arena_array(mem, methods, width, height, 
+                sizeof(uint8_t));
+        return words;
 }
+
 /**************************vcs_to_word********************************
  * 
  * Parameters: 
- *      A2Methods_UArray2 video_cs: 2d array of component video color space
+ *      vcs_planes video_cs: y, pb and pr planes of component video
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 of uncoded words containing structs with variables
- *      a, b, c, d, avpb and avpr
+ *      returns the planes of uncoded words a, b, c, d, avpb and avpr, one
+ *      cell per 2 by 2 block
  * 
- * Expects: valid 2d UArray, methods, and map
+ * Expects: valid planes of the same size, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
- *      deals with converting component video color space to uncoded word
+ *      deals with converting component video color space to uncoded word.
+ *      Plain arrays are walked a block row at a time by vcs_word_rows,
+ *      and other arrays with the map_2x2_blocks of their methods
  * 
  * *******************************************************************/
-A2Methods_UArray2 vcs_to_word(A2Methods_UArray2 video_cs, 
-        A2Methods_T methods, A2Methods_mapfun *map)
+word_planes vcs_to_word(vcs_planes video_cs, A2Methods_T methods, 
+        A2Methods_mapfun *map, arena mem)
 {
         /*since we are taking 4 values as in a box then the width
         and height of new array for bitword are halved*/
-        int width = (methods->width(video_cs)) / 2;
-        int height = (methods->height(video_cs)) / 2;
+        int width = (methods->width(video_cs.y)) / 2;
+        int height = (methods->height(video_cs.y)) / 2;
 
-        A2Methods_UArray2 word_arr = methods->new(width, height, 
-                sizeof(struct bitword));
+        word_planes words = new_word_planes(mem, methods, width, height);
 
+        if (rowloop_plain(methods)) {
+                plane_rows rows = { video_cs, words, NULL };
+                rowloop_run(methods, map, (unsigned) height, vcs_word_rows,
+                        &rows);
+                return words;
+        }
       
-        bit_cl cl = malloc(sizeof(struct bit_cl));
+        bit_cl cl = arena_alloc(mem, sizeof(struct bit_cl));
         assert(cl != NULL);
-        cl->array = video_cs;
         cl->methods = methods;
+        cl->pixels = video_cs;
+        cl->words = words;
 
-        map(word_arr, trans_vcs_word, cl);
-
-        if(cl != NULL) {
-                free(cl);
-                cl = NULL;
+        A2Methods_blockmapfun *blocks = block_map(methods, map);
+        if (blocks != NULL) {
+                blocks(video_cs.y, vcs_block_word, cl);
+                return words;
         }
+
+        map(words.a, trans_vcs_word, cl);
+
         
-        return word_arr; 
+        return words; 
 }
 /**************************trans_vcs_word********************************
  * 
  * Parameters:
- *      int col: col index of UArray_2 word_arr (uncoded words) 
- *      int row: row index of UArray_2 word_arr (uncoded words)
- *      A2Methods_UArray2 arr: 2D array containing struct of uncoded word
- *                              a, b, c, d, avpb and avpr
- *      void *elem: Component video color space pixels
- *      void *cl: a struct containing methods, and a UArray_2 for
- *              component video color space
+ *      int col: col index of the block in the word planes
+ *      int row: row index of the block in the word planes
+ *      A2Methods_UArray2 arr: the a plane of the uncoded words
+ *      void *elem: cell of the a plane of the block
+ *      void *cl: a struct containing methods, the component video planes
+ *              and the word planes
  * 
  * Return: 
  *      None
@@ -203,10 +346,10 @@ void trans_vcs_word(int col, int row, A2Methods_UArray2 arr, void *elem,
         void *cl) 
 {
         (void) arr;
-        color_space cs1, cs2, cs3, cs4;
-        float f_a, f_b, f_c, f_d;
+        (void) elem;
+        struct color_space cs[4];
+        struct bitword bit;
 
-        bitword bit = elem;
         bit_cl m_bitcl = cl;
 
         /*indices to be visited in a 2 by 2 block*/
@@ -214,77 +357,73 @@ void trans_vcs_word(int col, int row, A2Methods_UArray2 arr, void *elem,
         int c_row = 2 * row;
 
         /*getting the 2 by 2 block color space pixels values*/
-        cs1 = m_bitcl->methods->at(m_bitcl->array, c_col, c_row);
-        cs2 = m_bitcl->methods->at(m_bitcl->array, c_col + 1, c_row);
-        cs3 = m_bitcl->methods->at(m_bitcl->array, c_col, c_row + 1);
-        cs4 = m_bitcl->methods->at(m_bitcl->array, c_col + 1, c_row + 1);
-
-        f_a = (cs4->y + cs3->y + cs2->y + cs1->y)/4.0;
-        f_b = (cs4->y + cs3->y - cs2->y - cs1->y)/4.0;
-        f_c = (cs4->y - cs3->y + cs2->y - cs1->y)/4.0;
-        f_d = (cs4->y - cs3->y - cs2->y + cs1->y)/4.0;
-
-        float a_pb = (cs1->pb + cs2->pb + cs3->pb+ cs4->pb) / 4;
-        float a_pr = (cs1->pr + cs2->pr + cs3->pr+ cs4->pr) / 4;
-
-        bit->av_pb = (uint64_t) (Arith40_index_of_chroma(a_pb));
-        bit->av_pr = (uint64_t) (Arith40_index_of_chroma(a_pr));    
-        bit->a = a_float_to_int(f_a);
-        bit->b = bcd_float_to_int(f_b);
-        bit->c = bcd_float_to_int(f_c);
-        bit->d = bcd_float_to_int(f_d);
+        for (int k = 0; k < 4; k++) {
+                vcs_planes_get(m_bitcl->methods, m_bitcl->pixels, 
+                        c_col + k % 2, c_row + k / 2, &cs[k]);
+        }
 
+        block_to_bitword(&cs[0], &cs[1], &cs[2], &cs[3], &bit);
+        word_planes_put(m_bitcl->methods, m_bitcl->words, col, row, &bit);
 }
 /**************************word_to_vcs********************************
  * 
  * Parameters: 
- *      A2Methods_UArray2 word_arr: 2d array of uncoded words
+ *      word_planes words: planes of uncoded words
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 of component video colorspace containing structs
- *      whose variables are y, pb and pr
+ *      returns the y, pb and pr planes of the component video color space
  * 
- * Expects: valid 2d UArray, methods, and map
+ * Expects: valid planes of the same size, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
- *      deals with converting uncoded word to component video color space
+ *      deals with converting uncoded word to component video color space.
+ *      Plain arrays are walked a block row at a time by word_vcs_rows,
+ *      and other arrays with the map_2x2_blocks of their methods
  * 
  * *******************************************************************/
-A2Methods_UArray2 word_to_vcs(A2Methods_UArray2 word_arr, 
-        A2Methods_T methods, A2Methods_mapfun *map)
+vcs_planes word_to_vcs(word_planes words, A2Methods_T methods, 
+        A2Methods_mapfun *map, arena mem)
 {
-        int width = (methods->width(word_arr)) * 2;
-        int height = (methods->height(word_arr)) * 2;
+        int width = (methods->width(words.a)) * 2;
+        int height = (methods->height(words.a)) * 2;
 
-        A2Methods_UArray2 vcs_arr = methods->new(width, height, 
-                sizeof(struct color_space));
+        vcs_planes video_cs = vcs_planes_new(mem, methods, width, height);
+
+        if (rowloop_plain(methods)) {
+                plane_rows rows = { video_cs, words, NULL };
+                rowloop_run(methods, map, (unsigned) height / 2, 
+                        word_vcs_rows, &rows);
+                return video_cs;
+        }
        
-        bit_cl cl = malloc(sizeof(struct bit_cl));
+        bit_cl cl = arena_alloc(mem, sizeof(struct bit_cl));
         assert(cl != NULL);
-        cl->array = vcs_arr;
         cl->methods = methods;
+        cl->pixels = video_cs;
+        cl->words = words;
 
-        map(word_arr, transform_word, cl);
-
-        if(cl != NULL) {
-                free(cl);
-                cl = NULL;
+        A2Methods_blockmapfun *blocks = block_map(methods, map);
+        if (blocks != NULL) {
+                blocks(video_cs.y, word_vcs_block, cl);
+                return video_cs;
         }
 
-        return vcs_arr;  
+        map(words.a, transform_word, cl);
+
+        return video_cs;  
 }
 /**************************transform_word********************************
  * 
  * Parameters:
- *      int col: col index of UArray_2 word_arr (uncoded words) 
- *      int row: row index of UArray_2 word_arr (uncoded words)
- *      A2Methods_UArray2 arr: 2D array containing struct of uncoded word
- *                              a, b, c, d, avpb and avpr
- *      void *elem: struct of uncoded word a, b, c, d, avpb and avpr
- *      void *cl: a struct containing methods, and a UArray_2 for
- *              component video color space
+ *      int col: col index of the block in the word planes
+ *      int row: row index of the block in the word planes
+ *      A2Methods_UArray2 arr: the a plane of the uncoded words
+ *      void *elem: cell of the a plane of the block
+ *      void *cl: a struct containing methods, the component video planes
+ *              and the word planes
  * 
  * Return: 
  *      None
@@ -300,93 +439,76 @@ void transform_word(int col, int row, A2Methods_UArray2 arr, void *elem,
         void *cl)
 {
         (void) arr;
-        bitword bt = elem; 
+        (void) elem;
         bit_cl m_cl = cl; 
+        struct color_space vcs[4];
+        struct bitword bt;
 
         int idx_col = col * 2;
         int idx_row = row * 2;
 
-        float a, b, c, d, pb, pr;
-        a = a_int_to_float(bt->a);
-        b = bcd_int_to_float(bt->b);
-        c = bcd_int_to_float(bt->c);
-        d = bcd_int_to_float(bt->d);
-
-        pb = Arith40_chroma_of_index(bt->av_pb);
-        pr = Arith40_chroma_of_index(bt->av_pr);
-
-        color_space vcs1 = m_cl->methods->at(m_cl->array, idx_col, idx_row);
-        color_space vcs2 = m_cl->methods->at(m_cl->array, idx_col + 1, idx_row);
-        color_space vcs3 = m_cl->methods->at(m_cl->array, idx_col, idx_row + 1);
-        color_space vcs4 = m_cl->methods->at(m_cl->array, idx_col + 1, 
-                idx_row + 1);
-
-        vcs1->pb = pb;
-        vcs1->pr = pr;
-        vcs2->pb = pb;
-        vcs2->pr = pr;        
-        vcs3->pb = pb;
-        vcs3->pr = pr;
-        vcs4->pb = pb;
-        vcs4->pr = pr; 
-
-        vcs1->y = a_range(a - b - c + d);
-        vcs2->y = a_range(a - b + c - d);
-        vcs3->y = a_range(a + b - c - d);
-        vcs4->y = a_range(a + b + c + d);
+        word_planes_get(m_cl->methods, m_cl->words, col, row, &bt);
+        bitword_to_block(&bt, &vcs[0], &vcs[1], &vcs[2], &vcs[3]);
+
+        for (int k = 0; k < 4; k++) {
+                vcs_planes_put(m_cl->methods, m_cl->pixels, 
+                        idx_col + k % 2, idx_row + k / 2, &vcs[k]);
+        }
 }
 /**************************word_to_codedword********************************
  * 
  * Parameters: 
- *      A2Methods_UArray2 word_arr: 2d array of uncoded words
+ *      word_planes words: planes of uncoded words
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 of coded words whose elements are unsigned 64-bit 
+ *      returns a UArray_2 of coded words whose elements are unsigned 32-bit
  *      integers
  * 
- * Expects: valid 2d UArray, methods, and map
+ * Expects: valid planes of the same size, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
  *      deals with converting uncoded word to coded word using DCT 
- *      functions
+ *      functions. Plain arrays are walked a row at a time by pack_rows
  * 
  * *******************************************************************/
-A2Methods_UArray2 word_to_codedword(A2Methods_UArray2 word_arr, 
-        A2Methods_T methods, A2Methods_mapfun *map)
+A2Methods_UArray2 word_to_codedword(word_planes words, A2Methods_T methods,
+        A2Methods_mapfun *map, arena mem)
 {
-        int width = methods->width(word_arr);
-        int height = methods->height(word_arr);
+        int width = methods->width(words.a);
+        int height = methods->height(words.a);
 
-        A2Methods_UArray2 coded_arr = methods->new(width, height, 
-                sizeof(uint64_t));
+        A2Methods_UArray2 coded_arr = arena_array(mem, methods, width, 
+                height, sizeof(uint32_t));
 
+        if (rowloop_plain(methods)) {
+                plane_rows rows = { { NULL, NULL, NULL }, words, coded_arr };
+                rowloop_run(methods, map, (unsigned) height, pack_rows, 
+                        &rows);
+                return coded_arr;
+        }
        
-        bit_cl cl = malloc(sizeof(struct bit_cl));
+        bit_cl cl = arena_alloc(mem, sizeof(struct bit_cl));
         assert(cl != NULL);
         cl->array = coded_arr;
+        cl->words = words;
         cl->methods = methods;
 
-        map(word_arr, bitword_packing, cl);
+        map(coded_arr, bitword_packing, cl);
 
-        if(cl != NULL) {
-                free(cl);
-                cl = NULL;
-        }
         
         return coded_arr; 
 }
 /**************************bitword_packing********************************
  * 
  * Parameters:
- *      int col: col index of UArray_2 word_arr (uncoded words) 
- *      int row: row index of UArray_2 word_arr (uncoded words)
- *      A2Methods_UArray2 arr: 2D array containing struct of uncoded word
- *                              a, b, c, d, avpb and avpr
- *      void *elem: struct of uncoded word a, b, c, d, avpb and avpr
- *      void *cl: a struct containing methods, and a UArray_2 of uint64_t
- *              integers (coded words)
+ *      int col: col index of UArray_2 coded_arr (coded words)
+ *      int row: row index of UArray_2 coded_arr (coded words)
+ *      A2Methods_UArray2 arr: 2D array of uint32_t coded words
+ *      void *elem: coded word to be filled in
+ *      void *cl: a struct containing methods and the word planes
  * 
  * Return: 
  *      None
@@ -403,29 +525,12 @@ void bitword_packing(int col, int row, A2Methods_UArray2 arr, void *elem,
 {
         (void) arr;
         bit_cl mbit_cl = cl; 
-        bitword bit = elem; 
+        struct bitword bit;
 
-        uint64_t *pack_word = mbit_cl->methods->at(mbit_cl->array, col, row);
+        word_planes_get(mbit_cl->methods, mbit_cl->words, col, row, &bit);
 
         /*packing a, b, c, d, avpb and avpr*/
-        unsigned bcd_width = 5;
-        unsigned a_width = 9;
-        unsigned pba_width = 4;
-        unsigned a_lsb = 23;
-        unsigned b_lsb = 18;
-        unsigned c_lsb = 13;
-        unsigned d_lsb = 8;
-        unsigned pb_lsb = 4;
-        unsigned pr_lsb = 0;
-        uint64_t word = 0;
-        word = Bitpack_newu(word, a_width, a_lsb, bit->a);
-        word = Bitpack_news(word, bcd_width, b_lsb, bit->b);
-        word = Bitpack_news(word, bcd_width, c_lsb, bit->c);
-        word = Bitpack_news(word, bcd_width, d_lsb, bit->d);
-        word =  Bitpack_newu(word, pba_width, pb_lsb, bit->av_pb);
-        word = Bitpack_newu(word, pba_width, pr_lsb, bit->av_pr);
-
-        *pack_word = word;
+        *(uint32_t *) elem = pack_bitword(&bit);
 }
 /**************************codedword_to_word********************************
  * 
@@ -433,52 +538,52 @@ void bitword_packing(int col, int row, A2Methods_UArray2 arr, void *elem,
  *      A2Methods_UArray2 coded_arr: 2d array of coded words
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 of uncoded words whose elements are structs 
- *      containing a bitword with a, b, c, d, avpb and avpr
+ *      returns the planes of uncoded words a, b, c, d, avpb and avpr
  * 
  * Expects: valid 2d UArray, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
  *      deals with converting coded word to uncoded word using inverse DCT 
- *      functions
+ *      functions. Plain arrays are walked a row at a time by unpack_rows
  * 
  * *******************************************************************/
-A2Methods_UArray2 codedword_to_word(A2Methods_UArray2 coded_arr, 
-        A2Methods_T methods, A2Methods_mapfun *map)
+word_planes codedword_to_word(A2Methods_UArray2 coded_arr, 
+        A2Methods_T methods, A2Methods_mapfun *map, arena mem)
 {
         int width = methods->width(coded_arr);
         int height = methods->height(coded_arr);
 
-       
-        A2Methods_UArray2 word_arr = methods->new(width, height, 
-                sizeof(struct bitword));
+        word_planes words = new_word_planes(mem, methods, width, height);
+
+        if (rowloop_plain(methods)) {
+                plane_rows rows = { { NULL, NULL, NULL }, words, coded_arr };
+                rowloop_run(methods, map, (unsigned) height, unpack_rows, 
+                        &rows);
+                return words;
+        }
 
-        bit_cl cl = malloc(sizeof(struct bit_cl));
+        bit_cl cl = arena_alloc(mem, sizeof(struct bit_cl));
         assert(cl != NULL);
         cl->array = coded_arr;
+        cl->words = words;
         cl->methods = methods;
         
-        map(word_arr, bitword_unpacking, cl);
+        map(coded_arr, bitword_unpacking, cl);
 
-        if(cl != NULL) {
-                free(cl);
-                cl = NULL;
-        }
         
-        return word_arr; 
+        return words; 
 }
 /**************************bitword_unpacking********************************
  * 
  * Parameters:
- *      int col: col index of UArray_2 word_arr (uncoded words) 
- *      int row: row index of UArray_2 word_arr (uncoded words)
- *      A2Methods_UArray2 arr: 2D array containing struct of uncoded word
- *                              a, b, c, d, avpb and avpr
- *      void *elem: struct of uncoded word a, b, c, d, avpb and avpr
- *      void *cl: a struct containing methods, and a UArray_2 of uint64_t
- *              integers (coded words)
+ *      int col: col index of UArray_2 coded_arr (coded words)
+ *      int row: row index of UArray_2 coded_arr (coded words)
+ *      A2Methods_UArray2 arr: 2D array of uint32_t coded words
+ *      void *elem: coded word to be unpacked
+ *      void *cl: a struct containing methods and the word planes
  * 
  * Return: 
  *      None
@@ -495,25 +600,8 @@ void bitword_unpacking(int col, int row, A2Methods_UArray2 arr, void *elem,
 {
         (void) arr;
         bit_cl mbit_cl = cl; 
-        bitword bit = elem; 
+        struct bitword bit;
         
-        uint64_t *code_word = mbit_cl->methods->at(mbit_cl->array, col, row);
-        uint64_t word = *code_word;
-
-        unsigned bcd_width = 5;
-        unsigned a_width = 9;
-        unsigned pba_width = 4;
-        unsigned a_lsb = 23;
-        unsigned b_lsb = 18;
-        unsigned c_lsb = 13;
-        unsigned d_lsb = 8;
-        unsigned pb_lsb = 4;
-        unsigned pr_lsb = 0;
-      
-        bit->a = Bitpack_getu(word, a_width, a_lsb);
-        bit->b = Bitpack_gets(word, bcd_width, b_lsb);
-        bit->c = Bitpack_gets(word, bcd_width, c_lsb);
-        bit->d = Bitpack_gets(word, bcd_width, d_lsb);
-        bit->av_pb =  Bitpack_getu(word, pba_width, pb_lsb);
-        bit->av_pr = Bitpack_getu(word, pba_width, pr_lsb);
+        unpack_bitword(*(uint32_t *) elem, &bit);
+        word_planes_put(mbit_cl->methods, mbit_cl->words, col, row, &bit);
 }
@@ -17,6 +17,7 @@
 #include <math.h>
 #include "assert.h"
 #include "a2methods.h"
+#include "arena.h"
 #include "a2blocked.h"
 #include "arith40.h"
 #include "rgb_to_video.h"
@@ -32,42 +33,111 @@ typedef struct bitword {
         uint64_t av_pr;
 } *bitword;
 
+/*the uncoded words of an image as one plane per field, one cell per 2 by
+ 2 block, each cell only as wide as its field: 7 bytes a block where a
+ struct bitword takes 48*/
+typedef struct word_planes {
+        A2Methods_UArray2 a;            /*uint16_t*/
+        A2Methods_UArray2 b;            /*int8_t*/
+        A2Methods_UArray2 c;            /*int8_t*/
+        A2Methods_UArray2 d;            /*int8_t*/
+        A2Methods_UArray2 av_pb;        /*uint8_t*/
+        A2Methods_UArray2 av_pr;        /*uint8_t*/
+} word_planes;
+
 /*struct passed as a closure in the mapping or apply functions*/
 typedef struct bit_cl {
         A2Methods_UArray2 array;
+        vcs_planes pixels;
+        word_planes words;
         A2Methods_T methods;
 } *bit_cl;
 
+/**************************word_planes_get********************************
+ * 
+ * Parameters:
+ *      A2Methods_T methods: methods of the planes
+ *      word_planes planes: uncoded word planes
+ *      int col, row: block to be read
+ *      bitword bit: filled in with the uncoded word of the block
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid planes, col and row, and bit
+ * 
+ * *******************************************************************/
+static inline void word_planes_get(A2Methods_T methods, word_planes planes,
+        int col, int row, bitword bit)
+{
+        bit->a = *(uint16_t *) methods->at(planes.a, col, row);
+        bit->b = *(int8_t *) methods->at(planes.b, col, row);
+        bit->c = *(int8_t *) methods->at(planes.c, col, row);
+        bit->d = *(int8_t *) methods->at(planes.d, col, row);
+        bit->av_pb = *(uint8_t *) methods->at(planes.av_pb, col, row);
+        bit->av_pr = *(uint8_t *) methods->at(planes.av_pr, col, row);
+}
+
+/**************************word_planes_put********************************
+ * 
+ * Parameters:
+ *      A2Methods_T methods: methods of the planes
+ *      word_planes planes: uncoded word planes
+ *      int col, row: block to be written
+ *      const struct bitword *bit: uncoded word of the block
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid planes, col and row, and fields of bit that fit the
+ *      code word
+ * 
+ * *******************************************************************/
+static inline void word_planes_put(A2Methods_T methods, word_planes planes,
+        int col, int row, const struct bitword *bit)
+{
+        *(uint16_t *) methods->at(planes.a, col, row) = (uint16_t) bit->a;
+        *(int8_t *) methods->at(planes.b, col, row) = (int8_t) bit->b;
+        *(int8_t *) methods->at(planes.c, col, row) = (int8_t) bit->c;
+        *(int8_t *) methods->at(planes.d, col, row) = (int8_t) bit->d;
+        *(uint8_t *) methods->at(planes.av_pb, col, row) = 
+                (uint8_t) bit->av_pb;
+        *(uint8_t *) methods->at(planes.av_pr, col, row) = 
+                (uint8_t) bit->av_pr;
+}
+
 /**************************vcs_to_word********************************
  * 
  * Parameters: 
- *      A2Methods_UArray2 video_cs: 2d array of component video color space
+ *      vcs_planes video_cs: y, pb and pr planes of component video
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 of uncoded words containing structs with variables
- *      a, b, c, d, avpb and avpr
+ *      returns the planes of uncoded words a, b, c, d, avpb and avpr, one
+ *      cell per 2 by 2 block
  * 
- * Expects: valid 2d UArray, methods, and map
+ * Expects: valid planes of the same size, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
- *      deals with converting component video color space to uncoded word
+ *      deals with converting component video color space to uncoded word.
+ *      Plain arrays are walked a block row at a time by vcs_word_rows,
+ *      and other arrays with the map_2x2_blocks of their methods
  * 
  * *******************************************************************/
-extern A2Methods_UArray2 vcs_to_word(A2Methods_UArray2 video_cs, 
-        A2Methods_T methods, A2Methods_mapfun *map);
+extern word_planes vcs_to_word(vcs_planes video_cs, A2Methods_T methods, 
+        A2Methods_mapfun *map, arena mem);
 
 /**************************trans_vcs_word********************************
  * 
  * Parameters:
- *      int col: col index of UArray_2 word_arr (uncoded words) 
- *      int row: row index of UArray_2 word_arr (uncoded words)
- *      A2Methods_UArray2 arr: 2D array containing struct of uncoded word
- *                              a, b, c, d, avpb and avpr
- *      void *elem: Component video color space pixels
- *      void *cl: a struct containing methods, denominator and a UArray_2 for
- *              component video color space
+ *      int col: col index of the block in the word planes
+ *      int row: row index of the block in the word planes
+ *      A2Methods_UArray2 arr: the a plane of the uncoded words
+ *      void *elem: cell of the a plane of the block
+ *      void *cl: a struct containing methods, the component video planes
+ *              and the word planes
  * 
  * Return: 
  *      None
@@ -82,37 +152,37 @@ extern A2Methods_UArray2 vcs_to_word(A2Methods_UArray2 video_cs,
 extern void trans_vcs_word(int col, int row, A2Methods_UArray2 arr, 
         void *elem, void *cl);
 
-/**************************word_to_codedword********************************
+/**************************word_to_vcs********************************
  * 
  * Parameters: 
- *      A2Methods_UArray2 word_arr: 2d array of uncoded words
+ *      word_planes words: planes of uncoded words
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 of coded words whose elements are unsigned 64-bit 
- *      integers
+ *      returns the y, pb and pr planes of the component video color space
  * 
- * Expects: valid 2d UArray, methods, and map
+ * Expects: valid planes of the same size, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
- *      deals with converting coded word to uncoded word using DCT 
- *      functions
+ *      deals with converting uncoded word to component video color space.
+ *      Plain arrays are walked a block row at a time by word_vcs_rows,
+ *      and other arrays with the map_2x2_blocks of their methods
  * 
  * *******************************************************************/
-extern A2Methods_UArray2 word_to_codedword(A2Methods_UArray2 word_arr, 
-        A2Methods_T methods, A2Methods_mapfun *map);
+extern vcs_planes word_to_vcs(word_planes words, A2Methods_T methods, 
+        A2Methods_mapfun *map, arena mem);
 
-/**************************bitword_packing********************************
+/**************************transform_word********************************
  * 
  * Parameters:
- *      int col: col index of UArray_2 word_arr (uncoded words) 
- *      int row: row index of UArray_2 word_arr (uncoded words)
- *      A2Methods_UArray2 arr: 2D array containing struct of uncoded word
- *                              a, b, c, d, avpb and avpr
- *      void *elem: struct of uncoded word a, b, c, d, avpb and avpr
- *      void *cl: a struct containing methods, and a UArray_2 of uint64_t
- *              integers (coded words)
+ *      int col: col index of the block in the word planes
+ *      int row: row index of the block in the word planes
+ *      A2Methods_UArray2 arr: the a plane of the uncoded words
+ *      void *elem: cell of the a plane of the block
+ *      void *cl: a struct containing methods, the component video planes
+ *              and the word planes
  * 
  * Return: 
  *      None
@@ -120,44 +190,43 @@ extern A2Methods_UArray2 word_to_codedword(A2Methods_UArray2 word_arr,
  * Expects: valid col, row, arr, elem and cl
  * 
  * Notes: CRE is raised when invalid col and row is used to access
- *         elements in the 2d array. The function calls bitpacking field
- *         update functions to pack bits
+ *         elements in the 2d array. The function computes the y, pb and pr
+ *         in a 2 by 2 block
  * 
  * *******************************************************************/
-extern void bitword_packing(int col, int row, A2Methods_UArray2 arr, 
+extern void transform_word(int col, int row, A2Methods_UArray2 arr, 
         void *elem, void *cl);
 
-/**************************codedword_to_word********************************
+/**************************word_to_codedword********************************
  * 
  * Parameters: 
- *      A2Methods_UArray2 coded_arr: 2d array of coded words
+ *      word_planes words: planes of uncoded words
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 of uncoded words whose elements are structs 
- *      containing a bitword with a, b, c, d, avpb and avpr
+ *      returns a UArray_2 of coded words whose elements are unsigned 32-bit
+ *      integers
  * 
- * Expects: valid 2d UArray, methods, and map
+ * Expects: valid planes of the same size, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
- *      deals with converting coded word to uncoded word using inverse DCT 
- *      functions
+ *      deals with converting uncoded word to coded word using DCT 
+ *      functions. Plain arrays are walked a row at a time by pack_rows
  * 
  * *******************************************************************/
-A2Methods_UArray2 codedword_to_word(A2Methods_UArray2 coded_arr, 
-        A2Methods_T methods, A2Methods_mapfun *map);
+extern A2Methods_UArray2 word_to_codedword(word_planes words, 
+        A2Methods_T methods, A2Methods_mapfun *map, arena mem);
 
-/**************************bitword_unpacking********************************
+/**************************bitword_packing********************************
  * 
  * Parameters:
- *      int col: col index of UArray_2 word_arr (uncoded words) 
- *      int row: row index of UArray_2 word_arr (uncoded words)
- *      A2Methods_UArray2 arr: 2D array containing struct of uncoded word
- *                              a, b, c, d, avpb and avpr
- *      void *elem: struct of uncoded word a, b, c, d, avpb and avpr
- *      void *cl: a struct containing methods, and a UArray_2 of uint64_t
- *              integers (coded words)
+ *      int col: col index of UArray_2 coded_arr (coded words)
+ *      int row: row index of UArray_2 coded_arr (coded words)
+ *      A2Methods_UArray2 arr: 2D array of uint32_t coded words
+ *      void *elem: coded word to be filled in
+ *      void *cl: a struct containing methods and the word planes
  * 
  * Return: 
  *      None
@@ -166,42 +235,41 @@ A2Methods_UArray2 codedword_to_word(A2Methods_UArray2 coded_arr,
  * 
  * Notes: CRE is raised when invalid col and row is used to access
  *         elements in the 2d array. The function calls bitpacking field
- *         extraction functions to unpacking bits
+ *         update functions to pack bits
  * 
  * *******************************************************************/
-extern void bitword_unpacking(int col, int row, A2Methods_UArray2 arr, 
+extern void bitword_packing(int col, int row, A2Methods_UArray2 arr, 
         void *elem, void *cl);
 
-/**************************word_to_vcs********************************
+/**************************codedword_to_word********************************
  * 
  * Parameters: 
- *      A2Methods_UArray2 word_arr: 2d array of uncoded words
+ *      A2Methods_UArray2 coded_arr: 2d array of coded words
  *      A2_Methods_T methods: methods for UArray_2 operations
  *      A2Methods_mapfun *map: maps for UArray_2
+ *      arena mem: arena the result and its closure come from
  * 
  * Return: 
- *      returns a UArray_2 of component video colorspace containing structs
- *      whose variables are y, pb and pr
+ *      returns the planes of uncoded words a, b, c, d, avpb and avpr
  * 
  * Expects: valid 2d UArray, methods, and map
  * 
  * Notes: CRE is raised when malloc fails. This is the main function that
- *      deals with converting uncoded word to component video color space
+ *      deals with converting coded word to uncoded word using inverse DCT 
+ *      functions. Plain arrays are walked a row at a time by unpack_rows
  * 
  * *******************************************************************/
-extern A2Methods_UArray2 word_to_vcs(A2Methods_UArray2 word_arr, 
-        A2Methods_T methods, A2Methods_mapfun *map);
+extern word_planes codedword_to_word(A2Methods_UArray2 coded_arr, 
+        A2Methods_T methods, A2Methods_mapfun *map, arena mem);
 
-/**************************transform_word********************************
+/**************************bitword_unpacking********************************
  * 
  * Parameters:
- *      int col: col index of UArray_2 word_arr (uncoded words) 
- *      int row: row index of UArray_2 word_arr (uncoded words)
- *      A2Methods_UArray2 arr: 2D array containing struct of uncoded word
- *                              a, b, c, d, avpb and avpr
- *      void *elem: struct of uncoded word a, b, c, d, avpb and avpr
- *      void *cl: a struct containing methods, and a UArray_2 for
- *              component video color space
+ *      int col: col index of UArray_2 coded_arr (coded words)
+ *      int row: row index of UArray_2 coded_arr (coded words)
+ *      A2Methods_UArray2 arr: 2D array of uint32_t coded words
+ *      void *elem: coded word to be unpacked
+ *      void *cl: a struct containing methods and the word planes
  * 
  * Return: 
  *      None
@@ -209,10 +277,10 @@ extern A2Methods_UArray2 word_to_vcs(A2Methods_UArray2 word_arr,
  * Expects: valid col, row, arr, elem and cl
  * 
  * Notes: CRE is raised when invalid col and row is used to access
- *         elements in the 2d array. The function computes the y, pb and pr
- *         in a 2 by 2 block
+ *         elements in the 2d array. The function calls bitpacking field
+ *         extraction functions to unpacking bits
  * 
  * *******************************************************************/
-extern void transform_word(int col, int row, A2Methods_UArray2 arr, void *elem, 
-        void *cl);
-#endif
\ No newline at end of file
+extern void bitword_unpacking(int col, int row, A2Methods_UArray2 arr, 
+        void *elem, void *cl);
+#endif
@@ -0,0 +1,371 @@
+/***********************************************************************
+ * 
+ *                      wordio.c
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file implements bulk input and output of code words.
+ *              On output whole rows are byte-swapped into a large aligned
+ *              buffer that is given to fwrite in one piece, instead of
+ *              four putchar calls per word. On input a regular file is
+ *              mapped and rows are byte-swapped straight out of it, 
+ *              instead of four getc calls per word
+ * 
+ ***********************************************************************/
+/*fallocate and FALLOC_FL_KEEP_SIZE*/
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "assert.h"
+#include "wordio.h"
+#include "imageprocessor.h"
+#include "simd.h"
+
+/*bytes handed to fwrite at a time*/
+#define BUFSIZE (1 << 20)
+
+/**************************swap_words_scalar*****************************
+ * 
+ * Parameters: see swap_words
+ * 
+ * *******************************************************************/
+static void swap_words_scalar(const void *src, unsigned n, void *dst)
+{
+        const unsigned char *s = src;
+        unsigned char *d = dst;
+
+        for (unsigned i = 0; i < n; i++, s += 4, d += 4) {
+                uint32_t word;
+                memcpy(&word, s, 4);
+                word = __builtin_bswap32(word);
+                memcpy(d, &word, 4);
+        }
+}
+
+#if SIMD_X86
+/**************************swap_words_sse2*****************************
+ * 
+ * Parameters: see swap_words
+ * 
+ * Notes: four words per iteration; the 16-bit halves of each word are
+ *      exchanged, then the bytes of each half
+ * 
+ * *******************************************************************/
+static void swap_words_sse2(const void *src, unsigned n, void *dst)
+{
+        const unsigned char *s = src;
+        unsigned char *d = dst;
+        unsigned i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+                __m128i v = _mm_loadu_si128((const __m128i *) (s + 4 * i));
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+                v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+                _mm_storeu_si128((__m128i *) (d + 4 * i), v);
+        }
+        swap_words_scalar(s + 4 * i, n - i, d + 4 * i);
+}
+
+/**************************swap_words_avx2*****************************
+ * 
+ * Parameters: see swap_words
+ * 
+ * Notes: eight words per iteration with one byte shuffle
+ * 
+ * *******************************************************************/
+__attribute__((target("avx2")))
+static void swap_words_avx2(const void *src, unsigned n, void *dst)
+{
+        const unsigned char *s = src;
+        unsigned char *d = dst;
+        const __m256i reverse = _mm256_setr_epi8(
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        unsigned i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+                __m256i v = _mm256_loadu_si256((const __m256i *) (s + 4 * i));
+                _mm256_storeu_si256((__m256i *) (d + 4 * i), 
+                        _mm256_shuffle_epi8(v, reverse));
+        }
+        swap_words_sse2(s + 4 * i, n - i, d + 4 * i);
+}
+#endif
+
+/**************************swap_words********************************
+ * 
+ * Parameters:
+ *      const void *src: n 4-byte words
+ *      unsigned n: number of words
+ *      void *dst: n 4-byte words to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid buffers of 4 * n bytes, equal or not overlapping
+ * 
+ * Notes: dispatches to the best kernel for the cpu
+ * 
+ * *******************************************************************/
+void swap_words(const void *src, unsigned n, void *dst)
+{
+#if SIMD_X86
+        switch (simd_detect()) {
+        case SIMD_AVX2:
+                swap_words_avx2(src, n, dst);
+                return;
+        case SIMD_SSE2:
+                swap_words_sse2(src, n, dst);
+                return;
+        default:
+                break;
+        }
+#endif
+        swap_words_scalar(src, n, dst);
+}
+
+/**************************reserve_output********************************
+ * 
+ * Parameters:
+ *      FILE *fp: output file
+ *      uint64_t nbytes: number of bytes that will be written from the
+ *              current position
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid file pointer
+ * 
+ * Notes: failures are ignored; preallocation only helps the layout.
+ *      posix_fallocate would grow the file and, where the file system
+ *      has no fallocate, write zeros to do it; FALLOC_FL_KEEP_SIZE only
+ *      reserves blocks past the end
+ * 
+ * *******************************************************************/
+void reserve_output(FILE *fp, uint64_t nbytes)
+{
+        struct stat st;
+        int fd = fileno(fp);
+        off_t start = ftello(fp);
+
+        if (fd < 0 || start < 0 || nbytes == 0 || fstat(fd, &st) != 0 ||
+            !S_ISREG(st.st_mode)) {
+                return;
+        }
+        (void) fallocate(fd, FALLOC_FL_KEEP_SIZE, start, (off_t) nbytes);
+}
+
+/*writes out the bytes waiting in the buffer*/
+static void wordwriter_flush(word_writer writer)
+{
+        size_t written = fwrite(writer->buf, 1, writer->len, writer->fp);
+        assert(written == writer->len);
+        writer->len = 0;
+}
+
+/**************************wordwriter_new********************************
+ * 
+ * Parameters:
+ *      FILE *fp: output file
+ *      unsigned width: width in pixels of the (trimmed) image
+ *      unsigned height: height in pixels of the (trimmed) image
+ *      bool reserve: whether room for the image may be reserved in fp
+ *      arena mem: arena the writer and its buffer come from
+ * 
+ * Return: 
+ *      a word_writer that has printed the compressed image header
+ * 
+ * Expects: valid file pointer, even width and height
+ * 
+ * Notes: CRE is raised when malloc fails
+ * 
+ * *******************************************************************/
+word_writer wordwriter_new(FILE *fp, unsigned width, unsigned height,
+        bool reserve, arena mem)
+{
+        assert(fp != NULL);
+        word_writer writer = arena_alloc(mem, sizeof(*writer));
+        writer->fp = fp;
+        writer->len = 0;
+        writer->cap = BUFSIZE;
+        writer->buf = arena_alloc(mem, BUFSIZE);
+
+        char header[64];
+        int hlen = snprintf(header, sizeof(header),
+                "COMP40 Compressed image format 2\n%u %u\n", width, height);
+        assert(hlen > 0 && (size_t) hlen < sizeof(header));
+        if (reserve) {
+                reserve_output(fp, (uint64_t) hlen + 
+                        (uint64_t) (width / 2) * (height / 2) * 4);
+        }
+        size_t written = fwrite(header, 1, (size_t) hlen, fp);
+        assert(written == (size_t) hlen);
+        return writer;
+}
+
+/**************************wordwriter_row********************************
+ * 
+ * Parameters:
+ *      word_writer writer: writer returned by wordwriter_new
+ *      const uint32_t *words: one row of code words
+ *      unsigned n: number of code words in the row
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid writer and array of n words
+ * 
+ * Notes: CRE is raised when a write fails
+ * 
+ * *******************************************************************/
+void wordwriter_row(word_writer writer, const uint32_t *words, unsigned n)
+{
+        assert(writer != NULL && (words != NULL || n == 0));
+        while (n > 0) {
+                size_t room = (writer->cap - writer->len) / 4;
+                if (room == 0) {
+                        wordwriter_flush(writer);
+                        continue;
+                }
+                unsigned k = (n < room) ? n : (unsigned) room;
+                swap_words(words, k, writer->buf + writer->len);
+                writer->len += (size_t) k * 4;
+                words += k;
+                n -= k;
+        }
+}
+
+/**************************wordwriter_free********************************
+ * 
+ * Parameters:
+ *      word_writer *writer: pointer to the writer to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to a writer
+ * 
+ * Notes: CRE is raised when the last write fails
+ * 
+ * *******************************************************************/
+void wordwriter_free(word_writer *writer)
+{
+        assert(writer != NULL && *writer != NULL);
+        wordwriter_flush(*writer);
+        *writer = NULL;
+}
+
+/**************************wordreader_new********************************
+ * 
+ * Parameters:
+ *      FILE *fp: file pointer of a compressed binary image
+ *      bool mappable: whether a regular file may be mapped
+ *      arena mem: arena the reader comes from
+ * 
+ * Return: 
+ *      a word_reader positioned at the first row of code words
+ * 
+ * Expects: valid file pointer
+ * 
+ * Notes: the header is parsed with read_compressedheader, which leaves
+ *      fp right after it; that offset is where the words start in the
+ *      mapping. A file that is not mapped is read with fread
+ * 
+ * *******************************************************************/
+word_reader wordreader_new(FILE *fp, bool mappable, arena mem)
+{
+        assert(fp != NULL);
+        word_reader reader = arena_alloc(mem, sizeof(*reader));
+
+        reader->fp = fp;
+        reader->map = NULL;
+        reader->maplen = 0;
+        reader->next = NULL;
+        read_compressedheader(fp, &reader->width, &reader->height);
+
+        struct stat st;
+        off_t start = ftello(fp);
+        if (start < 0 || fstat(fileno(fp), &st) != 0 || 
+            !S_ISREG(st.st_mode)) {
+                return reader;
+        }
+
+        uint64_t need = (uint64_t) start + 
+                (uint64_t) (reader->width / 2) * (reader->height / 2) * 4;
+        if ((uint64_t) st.st_size < need) {
+                RAISE(file_err);
+        }
+        if (st.st_size == 0 || !mappable) {
+                return reader;
+        }
+
+        void *map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+                fileno(fp), 0);
+        if (map != MAP_FAILED) {
+                (void) madvise(map, (size_t) st.st_size, MADV_SEQUENTIAL);
+                reader->map = map;
+                reader->maplen = (size_t) st.st_size;
+                reader->next = reader->map + start;
+        }
+        return reader;
+}
+
+/**************************wordreader_row********************************
+ * 
+ * Parameters:
+ *      word_reader reader: reader returned by wordreader_new
+ *      uint32_t *words: array of n code words to be filled in
+ *      unsigned n: number of code words in the row
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid reader and array
+ * 
+ * Notes: without a mapping the row is read into words and swapped in
+ *      place
+ * 
+ * *******************************************************************/
+void wordreader_row(word_reader reader, uint32_t *words, unsigned n)
+{
+        assert(reader != NULL && (words != NULL || n == 0));
+        if (reader->map != NULL) {
+                assert((size_t) (reader->map + reader->maplen - 
+                        reader->next) >= (size_t) n * 4);
+                swap_words(reader->next, n, words);
+                reader->next += (size_t) n * 4;
+                return;
+        }
+
+        size_t got = fread(words, 4, n, reader->fp);
+        if (got != n) {
+                RAISE(file_err);
+        }
+        swap_words(words, n, words);
+}
+
+/**************************wordreader_free********************************
+ * 
+ * Parameters:
+ *      word_reader *reader: pointer to the reader to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to a reader
+ * 
+ * Notes: does not close the file
+ * 
+ * *******************************************************************/
+void wordreader_free(word_reader *reader)
+{
+        assert(reader != NULL && *reader != NULL);
+        if ((*reader)->map != NULL) {
+                munmap((*reader)->map, (*reader)->maplen);
+        }
+        *reader = NULL;
+}
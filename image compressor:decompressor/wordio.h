@@ -0,0 +1,202 @@
+/***********************************************************************
+ * 
+ *                      wordio.h
+ *      Assignment: Arith
+ *      Authors: Mishona Horton and Perucy Mussiba
+ *      Date: 10/17/2026
+ *      Purpose: This file contains the declarations of the bulk code
+ *              word input and output of wordio.c
+ * 
+ ***********************************************************************/
+#ifndef WORDIO_INCLUDED
+#define WORDIO_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "except.h"
+#include "arena.h"
+
+/*raised when a file is shorter than its header says; defined in
+ imageprocessor.c*/
+extern Except_T file_err;
+
+/*a compressed binary image being written: code words are byte-swapped
+ into buf and handed to the file a whole buffer at a time*/
+typedef struct word_writer {
+        FILE *fp;
+        unsigned char *buf;
+        size_t len;             /*bytes waiting in buf*/
+        size_t cap;
+} *word_writer;
+
+/*a compressed binary image being read: a regular file is mapped and
+ its rows are byte-swapped straight out of the mapping; other input is
+ read with fread a row at a time*/
+typedef struct word_reader {
+        FILE *fp;
+        unsigned width;         /*width in pixels*/
+        unsigned height;        /*height in pixels*/
+        unsigned char *map;     /*whole file, or NULL when not mapped*/
+        size_t maplen;
+        const unsigned char *next;      /*next code word in map*/
+} *word_reader;
+
+/**************************swap_words********************************
+ * 
+ * Parameters:
+ *      const void *src: n 4-byte words
+ *      unsigned n: number of words
+ *      void *dst: n 4-byte words to be filled in
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid buffers of 4 * n bytes, equal or not overlapping
+ * 
+ * Notes: reverses the bytes of every word, which turns native code words
+ *      into big-endian ones on x86 and back. Uses AVX2 or SSE2 when the
+ *      cpu has them
+ * 
+ * *******************************************************************/
+extern void swap_words(const void *src, unsigned n, void *dst);
+
+/**************************reserve_output********************************
+ * 
+ * Parameters:
+ *      FILE *fp: output file
+ *      uint64_t nbytes: number of bytes that will be written from the
+ *              current position
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid file pointer
+ * 
+ * Notes: when fp is a regular file, asks the file system to allocate the
+ *      space up front so the output is laid out in one piece. The size of
+ *      the file is left alone, so a run that stops early leaves only what
+ *      it wrote. Pipes, terminals and file systems that cannot preallocate
+ *      are left alone too; nothing is written in place of preallocating
+ * 
+ * *******************************************************************/
+extern void reserve_output(FILE *fp, uint64_t nbytes);
+
+/**************************wordwriter_new********************************
+ * 
+ * Parameters:
+ *      FILE *fp: output file
+ *      unsigned width: width in pixels of the (trimmed) image
+ *      unsigned height: height in pixels of the (trimmed) image
+ *      bool reserve: whether fp is a file of the run's own, where room
+ *              for the image may be reserved
+ *      arena mem: arena the writer and its buffer come from
+ * 
+ * Return: 
+ *      a word_writer that has printed the compressed image header
+ * 
+ * Expects: valid file pointer, even width and height
+ * 
+ * Notes: when reserve is set, reserves room for the whole image with
+ *      reserve_output. The writer lives until the arena is reset. CRE is
+ *      raised when malloc fails
+ * 
+ * *******************************************************************/
+extern word_writer wordwriter_new(FILE *fp, unsigned width, unsigned height,
+        bool reserve, arena mem);
+
+/**************************wordwriter_row********************************
+ * 
+ * Parameters:
+ *      word_writer writer: writer returned by wordwriter_new
+ *      const uint32_t *words: one row of code words
+ *      unsigned n: number of code words in the row
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid writer and array of n words
+ * 
+ * Notes: adds the code words in big-endian order, writing the buffer out
+ *      whenever it fills. CRE is raised when a write fails
+ * 
+ * *******************************************************************/
+extern void wordwriter_row(word_writer writer, const uint32_t *words,
+        unsigned n);
+
+/**************************wordwriter_free********************************
+ * 
+ * Parameters:
+ *      word_writer *writer: pointer to the writer to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to a writer
+ * 
+ * Notes: writes out what is left in the buffer and clears the pointer;
+ *      the memory goes back with its arena. The file is not closed
+ * 
+ * *******************************************************************/
+extern void wordwriter_free(word_writer *writer);
+
+/**************************wordreader_new********************************
+ * 
+ * Parameters:
+ *      FILE *fp: file pointer of a compressed binary image
+ *      bool mappable: whether a regular file may be mapped
+ *      arena mem: arena the reader comes from
+ * 
+ * Return: 
+ *      a word_reader positioned at the first row of code words
+ * 
+ * Expects: valid file pointer
+ * 
+ * Notes: reads the header. When fp is a regular file, its size is checked
+ *      against the header before anything is decoded, raising file_err
+ *      when it is too short, and the file is mapped if possible and
+ *      mappable. The pages of a mapping count against the memory of the
+ *      process, so a run under a memory budget reads instead. The
+ *      reader lives until the arena is reset. CRE is raised when the
+ *      header is invalid or malloc fails
+ * 
+ * *******************************************************************/
+extern word_reader wordreader_new(FILE *fp, bool mappable, arena mem);
+
+/**************************wordreader_row********************************
+ * 
+ * Parameters:
+ *      word_reader reader: reader returned by wordreader_new
+ *      uint32_t *words: array of n code words to be filled in
+ *      unsigned n: number of code words in the row
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid reader and array, and at most height / 2 rows of
+ *      width / 2 words in all
+ * 
+ * Notes: decodes the next n big-endian code words. file_err is raised
+ *      when input that could not be checked up front ends early
+ * 
+ * *******************************************************************/
+extern void wordreader_row(word_reader reader, uint32_t *words, unsigned n);
+
+/**************************wordreader_free********************************
+ * 
+ * Parameters:
+ *      word_reader *reader: pointer to the reader to be freed
+ * 
+ * Return: 
+ *      None
+ * 
+ * Expects: valid pointer to a reader
+ * 
+ * Notes: unmaps the file and clears the pointer; the memory goes back
+ *      with its arena. The file is not closed
+ * 
+ * *******************************************************************/
+extern void wordreader_free(word_reader *reader);
+
+#endif